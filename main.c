@@ -4,11 +4,35 @@
 
 #ifdef _WIN32
 #  define PATH_DELIM '\\'
+#  include <sys/utime.h>
 #else
 #  define PATH_DELIM '/'
+#  include <pthread.h>
+#  include <signal.h>
+#  include <sys/file.h>
+#  include <sys/resource.h>
+#  include <sys/mman.h>
+#  include <sys/socket.h>
+#  include <sys/un.h>
+#  include <utime.h>
 #endif // _WIN32
 
+#include <math.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(_M_X64)
+#  define SUBSTRING_SIMD 1
+#  include <immintrin.h>
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  endif // _MSC_VER
+#else
+#  define SUBSTRING_SIMD 0
+#endif
 #include "raylib.h"
+#include "rlgl.h"
+// raylib links GLFW in on desktop but does not declare these
+void glfwPostEmptyEvent(void);
+void glfwWaitEventsTimeout(double timeout);
 #define RGBa(r, g, b, a) ((Color) { (r), (g), (b), (a) })
 #define RGB(r, g, b) RGBa((r), (g), (b), 255)
 
@@ -20,6 +44,7 @@
 
 #define streq(a, b) (strcmp((a), (b)) == 0)
 #define MAX(a, b) ((b) < (a) ? (a) : (b))
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
 
 #ifndef DEFAULT_DIRECTORY
 #  define DEFAULT_DIRECTORY NULL
@@ -42,18 +67,316 @@ typedef struct {
   const char *folder;
   const char *name;
   const char *exe;
+  // Name picked by the user to show instead of the folder name, interned just like name
+  const char *alias;
 } Game;
 
-typedef List(Game) Games;
+const char *game_title(const Game *game) {
+  return game->alias ? game->alias : game->name;
+}
+
+typedef struct {
+  Game *items;
+  size_t count;
+  size_t capacity;
+  // Bumped whenever the list of games changes so anything derived from it can tell it went stale
+  size_t version;
+} Games;
+
+// Which games are shown and in which order, as indices into the catalog. A view without items shows the whole
+// catalog as it is
+typedef struct {
+  const size_t *items;
+  size_t count;
+  // Changes whenever the indices do
+  size_t version;
+} Game_View;
+
+typedef List(size_t) Game_Indices;
+
+// Every view takes its versions from here so two different views can never look the same to the layout. Atomic
+// since the persister sorts its copy of the library on its own thread
+static size_t game_view_versions = 0;
+
+size_t game_view_next_version(void) {
+  #ifdef _MSC_VER
+  return (size_t)InterlockedIncrement64((volatile LONG64 *)&game_view_versions);
+  #else
+  return __atomic_add_fetch(&game_view_versions, 1, __ATOMIC_RELAXED);
+  #endif // _MSC_VER
+}
 
 typedef struct {
   Game data;
+  size_t game_index;
   float x, y;
   float width, height;
   int title_width;
 } GameButton;
 
 
+// Every title shown goes through here so equal titles share one pointer and can be compared as such
+typedef struct {
+  const char **items;
+  size_t count;
+  size_t capacity;
+} Interns;
+
+static Interns title_interns = {0};
+// Folders and executables. A rescan throws the old catalog away while the workers and the persister may still hold
+// on to its paths, so they live as long as the program does
+static Interns path_interns = {0};
+
+uint64_t hash_cstr(const char *cstr) {
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char *c = cstr; *c; ++c) {
+    hash ^= (unsigned char)*c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+const char *intern_cstr(Interns *interns, const char *cstr) {
+  if (interns->count*2 >= interns->capacity) {
+    Interns grown = {0};
+    grown.capacity = interns->capacity ? interns->capacity*2 : NOB_DA_INIT_CAP;
+    grown.items = calloc(grown.capacity, sizeof(*grown.items));
+    NOB_ASSERT(grown.items != NULL && "Buy more RAM lol");
+    for (size_t i = 0; i < interns->capacity; ++i) {
+      const char *it = interns->items[i];
+      if (!it) continue;
+      size_t j = hash_cstr(it) & (grown.capacity - 1);
+      while (grown.items[j]) j = (j + 1) & (grown.capacity - 1);
+      grown.items[j] = it;
+      grown.count += 1;
+    }
+    free(interns->items);
+    *interns = grown;
+  }
+
+  size_t i = hash_cstr(cstr) & (interns->capacity - 1);
+  while (interns->items[i]) {
+    if (streq(interns->items[i], cstr)) return interns->items[i];
+    i = (i + 1) & (interns->capacity - 1);
+  }
+  interns->items[i] = strdup(cstr);
+  interns->count += 1;
+  return interns->items[i];
+}
+
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef CRITICAL_SECTION Mutex;
+typedef CONDITION_VARIABLE Cond;
+#else
+typedef pthread_t Thread;
+typedef pthread_mutex_t Mutex;
+typedef pthread_cond_t Cond;
+#endif // _WIN32
+
+typedef void (*Thread_Func)(void *arg);
+
+typedef struct {
+  Thread_Func func;
+  void *arg;
+} Thread_Start;
+
+#ifdef _WIN32
+DWORD WINAPI thread_trampoline(LPVOID arg) {
+  Thread_Start start = *(Thread_Start*)arg;
+  free(arg);
+  start.func(start.arg);
+  return 0;
+}
+#else
+void *thread_trampoline(void *arg) {
+  Thread_Start start = *(Thread_Start*)arg;
+  free(arg);
+  start.func(start.arg);
+  return NULL;
+}
+#endif // _WIN32
+
+bool thread_spawn(Thread *thread, Thread_Func func, void *arg) {
+  Thread_Start *start = malloc(sizeof(*start));
+  NOB_ASSERT(start != NULL && "Buy more RAM lol");
+  start->func = func;
+  start->arg = arg;
+  #ifdef _WIN32
+  *thread = CreateThread(NULL, 0, thread_trampoline, start, 0, NULL);
+  bool ok = *thread != NULL;
+  #else
+  bool ok = pthread_create(thread, NULL, thread_trampoline, start) == 0;
+  #endif // _WIN32
+  if (!ok) free(start);
+  return ok;
+}
+
+void thread_join(Thread thread) {
+  #ifdef _WIN32
+  WaitForSingleObject(thread, INFINITE);
+  CloseHandle(thread);
+  #else
+  pthread_join(thread, NULL);
+  #endif // _WIN32
+}
+
+#ifdef _WIN32
+void mutex_init(Mutex *mutex)   { InitializeCriticalSection(mutex); }
+void mutex_lock(Mutex *mutex)   { EnterCriticalSection(mutex); }
+void mutex_unlock(Mutex *mutex) { LeaveCriticalSection(mutex); }
+void cond_init(Cond *cond)               { InitializeConditionVariable(cond); }
+void cond_wait(Cond *cond, Mutex *mutex) { SleepConditionVariableCS(cond, mutex, INFINITE); }
+void cond_signal(Cond *cond)             { WakeConditionVariable(cond); }
+void cond_broadcast(Cond *cond)          { WakeAllConditionVariable(cond); }
+// Returns false when it gave up waiting
+bool cond_timed_wait(Cond *cond, Mutex *mutex, uint32_t ms) { return SleepConditionVariableCS(cond, mutex, ms); }
+#else
+void mutex_init(Mutex *mutex)   { pthread_mutex_init(mutex, NULL); }
+void mutex_lock(Mutex *mutex)   { pthread_mutex_lock(mutex); }
+void mutex_unlock(Mutex *mutex) { pthread_mutex_unlock(mutex); }
+void cond_init(Cond *cond)               { pthread_cond_init(cond, NULL); }
+void cond_wait(Cond *cond, Mutex *mutex) { pthread_cond_wait(cond, mutex); }
+void cond_signal(Cond *cond)             { pthread_cond_signal(cond); }
+void cond_broadcast(Cond *cond)          { pthread_cond_broadcast(cond); }
+bool cond_timed_wait(Cond *cond, Mutex *mutex, uint32_t ms) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += ms/1000;
+  deadline.tv_nsec += (long)(ms%1000)*1000000;
+  if (deadline.tv_nsec >= 1000000000) {
+    deadline.tv_sec += 1;
+    deadline.tv_nsec -= 1000000000;
+  }
+  return pthread_cond_timedwait(cond, mutex, &deadline) == 0;
+}
+#endif // _WIN32
+
+typedef void (*Parallel_For_Func)(void *ctx, size_t begin, size_t end);
+
+typedef struct {
+  Parallel_For_Func func;
+  void *ctx;
+  size_t begin, end;
+} Parallel_For_Chunk;
+
+void parallel_for_worker(void *arg) {
+  Parallel_For_Chunk *chunk = arg;
+  chunk->func(chunk->ctx, chunk->begin, chunk->end);
+}
+
+#define PARALLEL_FOR_MAX_THREADS 16
+
+// Splits [0, count) across the cores, the calling thread takes the first chunk. Small inputs are not worth
+// spawning threads for so anything below min_chunk items per thread just runs inline
+void parallel_for(size_t count, size_t min_chunk, Parallel_For_Func func, void *ctx) {
+  size_t threads = nob_nprocs();
+  if (threads > PARALLEL_FOR_MAX_THREADS) threads = PARALLEL_FOR_MAX_THREADS;
+  if (threads > count/min_chunk) threads = count/min_chunk;
+  if (threads <= 1) {
+    func(ctx, 0, count);
+    return;
+  }
+
+  Parallel_For_Chunk chunks[PARALLEL_FOR_MAX_THREADS] = {0};
+  Thread handles[PARALLEL_FOR_MAX_THREADS] = {0};
+  bool spawned[PARALLEL_FOR_MAX_THREADS] = {0};
+  size_t per_thread = (count + threads - 1)/threads;
+  for (size_t t = 0; t < threads; ++t) {
+    chunks[t] = (Parallel_For_Chunk) {
+      .func = func,
+      .ctx = ctx,
+      .begin = t*per_thread,
+      .end = (t + 1)*per_thread < count ? (t + 1)*per_thread : count,
+    };
+  }
+
+  for (size_t t = 1; t < threads; ++t) {
+    spawned[t] = thread_spawn(&handles[t], parallel_for_worker, &chunks[t]);
+  }
+
+  func(ctx, chunks[0].begin, chunks[0].end);
+  for (size_t t = 1; t < threads; ++t) {
+    if (!spawned[t]) {
+      // Could not get a thread, do the work ourselves instead of dropping it
+      func(ctx, chunks[t].begin, chunks[t].end);
+      continue;
+    }
+    thread_join(handles[t]);
+  }
+}
+
+
+typedef struct {
+  Thread_Func func;
+  void *arg;
+} Job;
+
+#define WORKER_POOL_MAX_THREADS 16
+
+// Long lived threads picking jobs off a shared stack. The most recently submitted job runs first, whoever submits
+// the work is the one that knows what is the most urgent right now
+typedef struct {
+  Job *items;
+  size_t count;
+  size_t capacity;
+  Mutex mutex;
+  Cond cond;
+  Thread threads[WORKER_POOL_MAX_THREADS];
+  size_t thread_count;
+  bool quit;
+} Worker_Pool;
+
+void worker_pool_loop(void *arg) {
+  Worker_Pool *pool = arg;
+  mutex_lock(&pool->mutex);
+  for (;;) {
+    while (pool->count == 0 && !pool->quit) cond_wait(&pool->cond, &pool->mutex);
+    if (pool->quit) break;
+    Job job = pool->items[--pool->count];
+    mutex_unlock(&pool->mutex);
+    job.func(job.arg);
+    mutex_lock(&pool->mutex);
+  }
+  mutex_unlock(&pool->mutex);
+}
+
+bool worker_pool_start(Worker_Pool *pool, size_t threads) {
+  mutex_init(&pool->mutex);
+  cond_init(&pool->cond);
+  pool->quit = false;
+  if (threads > WORKER_POOL_MAX_THREADS) threads = WORKER_POOL_MAX_THREADS;
+  for (size_t i = 0; i < threads; ++i) {
+    if (!thread_spawn(&pool->threads[pool->thread_count], worker_pool_loop, pool)) break;
+    pool->thread_count += 1;
+  }
+  if (pool->thread_count == 0) {
+    nob_log(NOB_ERROR, "Could not start any worker thread");
+    return false;
+  }
+  return true;
+}
+
+void worker_pool_submit(Worker_Pool *pool, Thread_Func func, void *arg) {
+  mutex_lock(&pool->mutex);
+  nob_da_append(pool, ((Job) { .func = func, .arg = arg }));
+  cond_signal(&pool->cond);
+  mutex_unlock(&pool->mutex);
+}
+
+// Jobs still queued are dropped, only meant for shutting down
+void worker_pool_stop(Worker_Pool *pool) {
+  mutex_lock(&pool->mutex);
+  pool->quit = true;
+  cond_broadcast(&pool->cond);
+  mutex_unlock(&pool->mutex);
+  for (size_t i = 0; i < pool->thread_count; ++i) thread_join(pool->threads[i]);
+  pool->thread_count = 0;
+  pool->count = 0;
+}
+
 bool read_games_dir(const char* games_dir, Games *games) {
   bool result = true;
   Nob_File_Paths children = {0};
@@ -93,10 +416,11 @@ bool read_games_dir(const char* games_dir, Games *games) {
       nob_sb_append_null(&dir_sb);
 
       nob_da_append(games, ((Game) {
-        .folder = dir_sb.items,
-        .name = strdup(dir),
-        .exe = strdup(f),
+        .folder = intern_cstr(&path_interns, dir_sb.items),
+        .name = intern_cstr(&title_interns, dir),
+        .exe = intern_cstr(&path_interns, f),
       }));
+      free(dir_sb.items);
     }
 
     free(files.items);
@@ -106,6 +430,7 @@ bool read_games_dir(const char* games_dir, Games *games) {
   nob_da_foreach(Game, it, games) {
     nob_log(NOB_INFO, "Found game: %s/%s", it->name, it->exe);
   }
+  games->version += 1;
 
 defer:
   if (sb.items) free(sb.items);
@@ -115,7 +440,10 @@ defer:
 
 
 void usage(const char *program) {
-  printf("Usage: %s <games-directory>\n", program);
+  printf("Usage: %s [options] <games-directory>\n", program);
+  printf("  --resident        Keep running with the window hidden when closed, later runs show it again\n");
+  printf("  --launch <title>  Launch the game with that title, through the resident lzua when there is one\n");
+  printf("  --quit            Ask the resident lzua to exit\n");
 }
 
 char *get_home_path() {
@@ -141,6 +469,313 @@ char *get_home_path() {
   #endif // _WIN32
 }
 
+// Directory where lzua may keep things that can be thrown away at any moment. Created if it does not exist yet
+char *get_cache_path(const char *home_dir) {
+  Nob_String_Builder sb = {0};
+  #ifdef _WIN32
+  const char *env = getenv("LOCALAPPDATA");
+  if (env) nob_sb_appendf(&sb, "%s", env);
+  else nob_sb_appendf(&sb, "%s\\AppData\\Local", home_dir);
+  #else
+  const char *env = getenv("XDG_CACHE_HOME");
+  if (env && env[0] == '/') nob_sb_appendf(&sb, "%s", env);
+  else nob_sb_appendf(&sb, "%s/.cache", home_dir);
+  #endif // _WIN32
+  nob_sb_append_null(&sb);
+  if (!nob_mkdir_if_not_exists(sb.items)) {
+    free(sb.items);
+    return NULL;
+  }
+
+  sb.count -= 1;
+  nob_sb_appendf(&sb, "%clzua", PATH_DELIM);
+  nob_sb_append_null(&sb);
+  if (!nob_mkdir_if_not_exists(sb.items)) {
+    free(sb.items);
+    return NULL;
+  }
+  return sb.items;
+}
+
+typedef struct {
+  void *data;
+  size_t size;
+  #ifdef _WIN32
+  HANDLE file;
+  HANDLE mapping;
+  #endif // _WIN32
+} Mapped_File;
+
+// Maps a whole file read only, does not log since a missing file is usually an expected outcome
+bool map_file(const char *path, Mapped_File *mf) {
+  *mf = (Mapped_File) {0};
+  #ifdef _WIN32
+  mf->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (mf->file == INVALID_HANDLE_VALUE) return false;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(mf->file, &size) || size.QuadPart == 0) {
+    CloseHandle(mf->file);
+    return false;
+  }
+  mf->size = (size_t)size.QuadPart;
+  mf->mapping = CreateFileMappingA(mf->file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mf->mapping == NULL) {
+    CloseHandle(mf->file);
+    return false;
+  }
+  mf->data = MapViewOfFile(mf->mapping, FILE_MAP_READ, 0, 0, 0);
+  if (mf->data == NULL) {
+    CloseHandle(mf->mapping);
+    CloseHandle(mf->file);
+    return false;
+  }
+  return true;
+  #else
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) < 0 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) return false;
+  mf->data = data;
+  mf->size = st.st_size;
+  return true;
+  #endif // _WIN32
+}
+
+void unmap_file(Mapped_File *mf) {
+  if (!mf->data) return;
+  #ifdef _WIN32
+  UnmapViewOfFile(mf->data);
+  CloseHandle(mf->mapping);
+  CloseHandle(mf->file);
+  #else
+  munmap(mf->data, mf->size);
+  #endif // _WIN32
+  *mf = (Mapped_File) {0};
+}
+
+// Replaces whatever the file had with data and only returns once it reached the disk
+bool write_file_synced(const char *path, const void *data, size_t size) {
+  const char *cursor = data;
+  size_t left = size;
+  bool ok = true;
+  #ifdef _WIN32
+  HANDLE file = CreateFileA(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    nob_log(NOB_ERROR, "Could not open %s: %s", path, nob_win32_error_message(GetLastError()));
+    return false;
+  }
+  while (ok && left > 0) {
+    DWORD written = 0;
+    ok = WriteFile(file, cursor, (DWORD)MIN(left, (size_t)1 << 30), &written, NULL);
+    cursor += written;
+    left -= written;
+  }
+  ok = ok && FlushFileBuffers(file);
+  if (!ok) nob_log(NOB_ERROR, "Could not write %s: %s", path, nob_win32_error_message(GetLastError()));
+  CloseHandle(file);
+  #else
+  int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    nob_log(NOB_ERROR, "Could not open %s: %s", path, strerror(errno));
+    return false;
+  }
+  while (ok && left > 0) {
+    ssize_t written = write(fd, cursor, left);
+    if (written < 0 && errno == EINTR) continue;
+    ok = written > 0;
+    if (ok) {
+      cursor += written;
+      left -= (size_t)written;
+    }
+  }
+  ok = ok && fsync(fd) == 0;
+  if (!ok) nob_log(NOB_ERROR, "Could not write %s: %s", path, strerror(errno));
+  ok = close(fd) == 0 && ok;
+  #endif // _WIN32
+  return ok;
+}
+
+// Written and synced under another name first and then moved over the old one, so whenever the process dies the
+// file is either the old one or the new one and never half written. The directory is synced after the rename so the
+// new name survives a power cut too. Stays off the temp arena since the persister calls it from its own thread
+bool replace_file(const char *path, const void *data, size_t size) {
+  Nob_String_Builder tmp_sb = {0};
+  // Each process writes its own temporary, two of them saving at once must not write into the same one
+  #ifdef _WIN32
+  nob_sb_appendf(&tmp_sb, "%s.%lu.tmp", path, (unsigned long)GetCurrentProcessId());
+  #else
+  nob_sb_appendf(&tmp_sb, "%s.%ld.tmp", path, (long)getpid());
+  #endif // _WIN32
+  const char *tmp = tmp_sb.items;
+  bool result = write_file_synced(tmp, data, size);
+  if (result) {
+    #ifdef _WIN32
+    result = MoveFileExA(tmp, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+    if (!result) nob_log(NOB_WARNING, "Could not replace %s: %s", path, nob_win32_error_message(GetLastError()));
+    #else
+    result = rename(tmp, path) == 0;
+    if (!result) nob_log(NOB_WARNING, "Could not replace %s: %s", path, strerror(errno));
+    #endif // _WIN32
+  }
+  if (!result) remove(tmp);
+
+  #ifndef _WIN32
+  if (result) {
+    const char *slash = strrchr(path, PATH_DELIM);
+    tmp_sb.count = 0;
+    if (slash) nob_sb_append_buf(&tmp_sb, path, MAX(slash - path, 1));
+    else nob_sb_append_cstr(&tmp_sb, ".");
+    nob_sb_append_null(&tmp_sb);
+    const char *dir = tmp_sb.items;
+    int fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+      fsync(fd);
+      close(fd);
+    }
+  }
+  #endif // _WIN32
+  free(tmp_sb.items);
+  return result;
+}
+
+// A file every instance using the same games directory appends to, held under an exclusive lock from open to close.
+// Appends go to wherever the file ends then, never to an offset this process remembers, since another instance may
+// have appended to it or emptied it in between. On Windows the lock is on a byte far past the end so it does not get
+// in the way of reading the file
+#define LOCKED_FILE_LOCK_OFFSET_HIGH 0x7fffffff
+
+typedef struct {
+  #ifdef _WIN32
+  HANDLE file;
+  #else
+  int fd;
+  #endif // _WIN32
+} Locked_File;
+
+// Waits for the lock. Without create a missing file is an error
+bool locked_file_open(Locked_File *lf, const char *path, bool create) {
+  #ifdef _WIN32
+  lf->file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                         create ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (lf->file == INVALID_HANDLE_VALUE) {
+    if (create) nob_log(NOB_ERROR, "Could not open %s: %s", path, nob_win32_error_message(GetLastError()));
+    return false;
+  }
+  OVERLAPPED at = { .OffsetHigh = LOCKED_FILE_LOCK_OFFSET_HIGH };
+  if (!LockFileEx(lf->file, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &at)) {
+    nob_log(NOB_ERROR, "Could not lock %s: %s", path, nob_win32_error_message(GetLastError()));
+    CloseHandle(lf->file);
+    return false;
+  }
+  #else
+  lf->fd = open(path, O_RDWR | O_APPEND | O_CLOEXEC | (create ? O_CREAT : 0), 0644);
+  if (lf->fd < 0) {
+    if (create) nob_log(NOB_ERROR, "Could not open %s: %s", path, strerror(errno));
+    return false;
+  }
+  int locked = 0;
+  while ((locked = flock(lf->fd, LOCK_EX)) < 0 && errno == EINTR) {}
+  if (locked < 0) {
+    nob_log(NOB_ERROR, "Could not lock %s: %s", path, strerror(errno));
+    close(lf->fd);
+    return false;
+  }
+  #endif // _WIN32
+  return true;
+}
+
+// Closing drops the lock
+void locked_file_close(Locked_File *lf) {
+  #ifdef _WIN32
+  OVERLAPPED at = { .OffsetHigh = LOCKED_FILE_LOCK_OFFSET_HIGH };
+  UnlockFileEx(lf->file, 0, 1, 0, &at);
+  CloseHandle(lf->file);
+  #else
+  close(lf->fd);
+  #endif // _WIN32
+}
+
+bool locked_file_size(const Locked_File *lf, size_t *size) {
+  #ifdef _WIN32
+  LARGE_INTEGER li;
+  if (!GetFileSizeEx(lf->file, &li)) return false;
+  *size = (size_t)li.QuadPart;
+  #else
+  struct stat st;
+  if (fstat(lf->fd, &st) < 0) return false;
+  *size = (size_t)st.st_size;
+  #endif // _WIN32
+  return true;
+}
+
+// All of it, the lock keeps it from changing while it is read
+bool locked_file_read(const Locked_File *lf, Nob_String_Builder *sb) {
+  size_t size = 0;
+  if (!locked_file_size(lf, &size)) return false;
+  nob_da_reserve(sb, sb->count + size);
+  size_t done = 0;
+  while (done < size) {
+    #ifdef _WIN32
+    DWORD got = 0;
+    OVERLAPPED at = { .Offset = (DWORD)done, .OffsetHigh = (DWORD)((uint64_t)done >> 32) };
+    if (!ReadFile(lf->file, sb->items + sb->count + done, (DWORD)MIN(size - done, (size_t)1 << 30), &got, &at)) return false;
+    #else
+    ssize_t got = pread(lf->fd, sb->items + sb->count + done, size - done, (off_t)done);
+    if (got < 0 && errno == EINTR) continue;
+    if (got < 0) return false;
+    #endif // _WIN32
+    if (got == 0) break;
+    done += (size_t)got;
+  }
+  sb->count += done;
+  return true;
+}
+
+// Only returns once it reached the disk
+bool locked_file_append(Locked_File *lf, const void *data, size_t size) {
+  const char *cursor = data;
+  size_t left = size;
+  bool ok = true;
+  #ifdef _WIN32
+  LARGE_INTEGER zero = {0};
+  ok = SetFilePointerEx(lf->file, zero, NULL, FILE_END);
+  while (ok && left > 0) {
+    DWORD written = 0;
+    ok = WriteFile(lf->file, cursor, (DWORD)MIN(left, (size_t)1 << 30), &written, NULL);
+    cursor += written;
+    left -= written;
+  }
+  ok = ok && FlushFileBuffers(lf->file);
+  #else
+  while (ok && left > 0) {
+    ssize_t written = write(lf->fd, cursor, left);
+    if (written < 0 && errno == EINTR) continue;
+    ok = written > 0;
+    if (ok) {
+      cursor += written;
+      left -= (size_t)written;
+    }
+  }
+  ok = ok && fsync(lf->fd) == 0;
+  #endif // _WIN32
+  return ok;
+}
+
+bool locked_file_truncate(Locked_File *lf, size_t size) {
+  #ifdef _WIN32
+  LARGE_INTEGER at = { .QuadPart = (LONGLONG)size };
+  return SetFilePointerEx(lf->file, at, NULL, FILE_BEGIN) && SetEndOfFile(lf->file) && FlushFileBuffers(lf->file);
+  #else
+  return ftruncate(lf->fd, (off_t)size) == 0 && fsync(lf->fd) == 0;
+  #endif // _WIN32
+}
+
 
 #define GENERAL_PADDING 10.0f
 
@@ -149,132 +784,6845 @@ char *get_home_path() {
 #define GAME_BUTTON_BASE_COLOR RGB(54, 54, 54)
 #define GAME_BUTTON_HOVR_COLOR RGB(80, 80, 80)
 #define GAME_BUTTON_PICK_COLOR RGB(180, 80, 80)
+#define GAME_BUTTON_LINE_COLOR RGB(200, 100, 150)
+#define GAME_BUTTON_FOCUS_COLOR RGB(240, 200, 120)
+#define GAME_BUTTON_TEXT_COLOR RGB(200, 180, 200)
+#define GAME_BUTTON_ROUNDNESS 0.05f
+#define GAME_BUTTON_SEGMENTS 4
+#define GAME_BUTTON_ART_MARGIN 8.0f
 
-void calculate_game_buttons_positions(Rectangle bounds, Games games, GameButton *buttons) {
-  memset(buttons, 0, sizeof(GameButton) * games.count);
+#define ART_THUMB_SIZE 48 // Artwork is scaled to fit a square of this size at the top of the tile
 
-  for (size_t i = 0; i < games.count; ++i) {
-    int text_width = MeasureText(games.items[i].name, GAME_BUTTON_FONT_SIZE);
-    buttons[i].data = games.items[i];
-    buttons[i].width = MAX(GAME_BUTTON_HEIGHT, text_width + GENERAL_PADDING*2);
-    buttons[i].height = GAME_BUTTON_HEIGHT;
-    buttons[i].title_width = text_width;
-  }
-  if (games.count == 0) return;
+// A run of consecutive buttons that share the same line of the grid
+typedef struct {
+  size_t start;
+  size_t count;
+  float width;
+  float y;
+} Layout_Row;
 
-  size_t save = nob_temp_save();
-  GameButton **row = nob_temp_alloc(sizeof(GameButton*)*games.count);
-  size_t last_i = 0;
+typedef List(Layout_Row) Layout_Rows;
+
+// Greedily packs the already measured buttons into rows, visiting every button exactly once
+void pack_game_buttons_rows(Rectangle bounds, GameButton *buttons, size_t count, Layout_Rows *rows) {
+  rows->count = 0;
 
   float bounds_width = bounds.width - bounds.x - GENERAL_PADDING*2;
   float y = bounds.y + GENERAL_PADDING;
-  while (last_i < games.count) {
-    float row_width = 0;
-    size_t row_sz = 0;
-    memset(row, 0, sizeof(GameButton*)*games.count);
-
-    for (size_t i = last_i; i < games.count; ++i) {
-      if (row_sz == 0) {
-        row[row_sz++] = &buttons[i];
-        row_width = buttons[i].width;
-        continue;
-      }
-
-      GameButton gb = buttons[i];
-      float alusive_width = row_width + GENERAL_PADDING + gb.width;
+  size_t i = 0;
+  while (i < count) {
+    Layout_Row row = { .start = i, .count = 1, .width = buttons[i].width, .y = y };
+    for (i += 1; i < count; ++i) {
+      float alusive_width = row.width + GENERAL_PADDING + buttons[i].width;
       if (alusive_width >= bounds_width) break;
-      row[row_sz++] = &buttons[i];
-      row_width = alusive_width;
+      row.width = alusive_width;
+      row.count += 1;
     }
 
-    float x = bounds.x + GENERAL_PADDING + (bounds_width/2.0f - row_width/2.0f);
-    for (size_t i = 0; i < row_sz; ++i) {
-      row[i]->x = x;
-      row[i]->y = y;
-      x += row[i]->width + GENERAL_PADDING;
+    float x = bounds.x + GENERAL_PADDING + (bounds_width/2.0f - row.width/2.0f);
+    for (GameButton *gb = buttons + row.start; gb < buttons + row.start + row.count; ++gb) {
+      gb->x = x;
+      gb->y = y;
+      x += gb->width + GENERAL_PADDING;
     }
 
-    last_i += row_sz;
+    nob_da_append(rows, row);
     y += GAME_BUTTON_HEIGHT + GENERAL_PADDING;
   }
+}
 
-  nob_temp_rewind(save);
+// The default font is drawn with the spacing MeasureText and DrawText use, actual TTF fonts already space their glyphs
+float title_spacing(Font font, int font_size) {
+  int default_font_size = 10;
+  if (font.texture.id != GetFontDefault().texture.id) return 0.0f;
+  if (font_size < default_font_size) font_size = default_font_size;
+  return (float)(font_size/default_font_size);
 }
 
-Button_State game_button(GameButton *gb) {
-  Rectangle bounds = { .x = gb->x, .y = gb->y, .width = gb->width, .height = GAME_BUTTON_HEIGHT };
-  Button_State state = BUTTON_STATE_NONE;
-  if (CheckCollisionPointRec(GetMousePosition(), bounds)) {
-    state = state | BUTTON_STATE_HOVER;
-    DrawRectangleRounded(bounds, 0.05f, 4, GAME_BUTTON_HOVR_COLOR);
+int measure_title(Font font, const char *title, int font_size) {
+  return (int) MeasureTextEx(font, title, (float)font_size, title_spacing(font, font_size)).x;
+}
 
-    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-      state = state | BUTTON_STATE_CLICK;
-    }
-  } else {
-    DrawRectangleRounded(bounds, 0.05f, 4, GAME_BUTTON_BASE_COLOR);
+
+// Fonts tried in order when LZUA_FONT is not set, whichever exists first wins
+static const char *ui_font_candidates[] = {
+  #ifdef _WIN32
+  "C:\\Windows\\Fonts\\segoeui.ttf",
+  "C:\\Windows\\Fonts\\arial.ttf",
+  #else
+  "/usr/share/fonts/truetype/noto/NotoSans-Regular.ttf",
+  "/usr/share/fonts/noto/NotoSans-Regular.ttf",
+  "/usr/share/fonts/google-noto/NotoSans-Regular.ttf",
+  "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+  "/usr/share/fonts/TTF/DejaVuSans.ttf",
+  "/usr/share/fonts/dejavu/DejaVuSans.ttf",
+  #endif // _WIN32
+};
+
+#define UI_FONT_GLYPH_PADDING 2
+#define UI_FONT_CACHE_MAGIC 0x544e464c // "LFNT"
+#define UI_FONT_CACHE_VERSION 1
+
+typedef struct {
+  int *items;
+  size_t count;
+  size_t capacity;
+} Codepoints;
+
+// Font for the titles. Only the glyphs the catalog actually uses get rasterized, the atlas grows when titles with
+// new codepoints show up and is kept on disk so the next start does not rasterize anything
+typedef struct {
+  Font font;
+  // False while using the default font of raylib, either because no TTF was found or because it failed to load
+  bool loaded;
+  int size;
+  Nob_String_Builder file;
+  // Sorted, the codepoints font.glyphs holds
+  Codepoints codepoints;
+  size_t catalog_version;
+  char *cache_path;
+} Ui_Font;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t size;
+  uint32_t glyph_count;
+  uint32_t atlas_width;
+  uint32_t atlas_height;
+} Ui_Font_Cache_Header;
+
+typedef struct {
+  int32_t value;
+  int32_t offset_x, offset_y, advance_x;
+  float x, y, width, height;
+} Ui_Font_Cache_Glyph;
+
+bool codepoints_contains(const Codepoints *cps, int codepoint) {
+  size_t lo = 0, hi = cps->count;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo)/2;
+    if (cps->items[mid] < codepoint) lo = mid + 1;
+    else hi = mid;
   }
-  DrawRectangleRoundedLines(bounds, 0.05f, 4, RGB(200, 100, 150));
-  int text_x = (int) (bounds.x + (bounds.width / 2.0 - gb->title_width / 2.0));
-  int text_y = (int)(bounds.y + bounds.height / 2.0);
-  DrawText(gb->data.name, text_x, text_y, GAME_BUTTON_FONT_SIZE, RGB(200, 180, 200));
-  return state;
+  return lo < cps->count && cps->items[lo] == codepoint;
 }
 
+int compare_ints(const void *a, const void *b) {
+  int x = *(const int*)a, y = *(const int*)b;
+  return (x > y) - (x < y);
+}
 
-int main(int argc, const char **argv) {
-  const char *program = nob_shift(argv, argc);
-  (void) program;
+// Takes ownership of glyphs, builds the atlas out of their images and replaces the current font with it
+void ui_font_replace_glyphs(Ui_Font *uf, GlyphInfo *glyphs, int glyph_count) {
+  Rectangle *recs = NULL;
+  Image atlas = GenImageFontAtlas(glyphs, &recs, glyph_count, uf->size, UI_FONT_GLYPH_PADDING, 0);
 
-  const char *games_dir = NULL;
-  while (argc > 0) {
-    const char *arg = nob_shift(argv, argc);
-    if (arg[0] != '-' && !games_dir) {
-      games_dir = arg;
-      continue;
-    }
+  if (uf->loaded) {
+    UnloadTexture(uf->font.texture);
+    free(uf->font.recs);
+  }
+  uf->font = (Font) {
+    .baseSize = uf->size,
+    .glyphCount = glyph_count,
+    .glyphPadding = UI_FONT_GLYPH_PADDING,
+    .texture = LoadTextureFromImage(atlas),
+    .recs = recs,
+    .glyphs = glyphs,
+  };
+  SetTextureFilter(uf->font.texture, TEXTURE_FILTER_BILINEAR);
+  uf->loaded = true;
 
-    if (arg[0] == '-') {
-      nob_log(NOB_ERROR, "Unknown flag passed: %s", arg);
-      usage(program);
-    } else {
-      nob_log(NOB_ERROR, "Unknown command passed: %s", arg);
-      usage(program);
+  uf->codepoints.count = 0;
+  for (int i = 0; i < glyph_count; ++i) nob_da_append(&uf->codepoints, glyphs[i].value);
+  qsort(uf->codepoints.items, uf->codepoints.count, sizeof(int), compare_ints);
+
+  if (uf->cache_path) {
+    Ui_Font_Cache_Header header = {
+      .magic = UI_FONT_CACHE_MAGIC, .version = UI_FONT_CACHE_VERSION, .size = uf->size,
+      .glyph_count = glyph_count, .atlas_width = atlas.width, .atlas_height = atlas.height,
+    };
+    Nob_String_Builder sb = {0};
+    nob_sb_append_buf(&sb, (const char *)&header, sizeof(header));
+    for (int i = 0; i < glyph_count; ++i) {
+      Ui_Font_Cache_Glyph glyph = {
+        .value = glyphs[i].value, .offset_x = glyphs[i].offsetX, .offset_y = glyphs[i].offsetY,
+        .advance_x = glyphs[i].advanceX,
+        .x = recs[i].x, .y = recs[i].y, .width = recs[i].width, .height = recs[i].height,
+      };
+      nob_sb_append_buf(&sb, (const char *)&glyph, sizeof(glyph));
     }
-    return 1;
+    nob_sb_append_buf(&sb, (const char *)atlas.data, (size_t)atlas.width*atlas.height*2);
+    // Never written in place, a crash or another lzua writing it at the same time must not leave a torn atlas behind
+    if (!replace_file(uf->cache_path, sb.items, sb.count)) {
+      nob_log(NOB_WARNING, "Could not save the glyph atlas to %s", uf->cache_path);
+    }
+    free(sb.items);
   }
+  UnloadImage(atlas);
+}
 
-  if (!games_dir) {
-    games_dir = DEFAULT_DIRECTORY;
-    if (!games_dir) {
-      nob_log(NOB_ERROR, "Must pass in the folder of the folders of executables");
-      return 1;
-    } else {
-      nob_log(NOB_INFO, "Loading default dir: %s\n", games_dir);
+// The atlas is GRAY_ALPHA with the coverage in the alpha, glyph images are expected as plain GRAYSCALE coverage
+Image ui_font_glyph_from_atlas(Image atlas, Rectangle rec) {
+  int width = (int)rec.width, height = (int)rec.height;
+  unsigned char *pixels = calloc(MAX(1, width*height), 1);
+  NOB_ASSERT(pixels != NULL && "Buy more RAM lol");
+  const unsigned char *src = atlas.data;
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      pixels[y*width + x] = src[(((int)rec.y + y)*atlas.width + (int)rec.x + x)*2 + 1];
     }
   }
+  return (Image) { .data = pixels, .width = width, .height = height, .mipmaps = 1, .format = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE };
+}
 
-  const char *home_dir = get_home_path();
-  if (!home_dir) {
-    nob_log(NOB_ERROR, "Failed to get the home path from the environment. Cannot load custom configs");
-    return 1;
-  }
+bool ui_font_load_cache(Ui_Font *uf) {
+  Mapped_File mf = {0};
+  if (!map_file(uf->cache_path, &mf)) return false;
 
-  Nob_Cmd cmd = {0};
-  Nob_Procs processes = {
-    .items = malloc(sizeof(Nob_Proc)), // In theory there shouldn't be more than one
-    .capacity = 1,
-    .count = 0,
+  bool result = true;
+  Ui_Font_Cache_Header header = {0};
+  if (mf.size < sizeof(header)) nob_return_defer(false);
+  memcpy(&header, mf.data, sizeof(header));
+  size_t glyphs_size = (size_t)header.glyph_count*sizeof(Ui_Font_Cache_Glyph);
+  size_t atlas_size = (size_t)header.atlas_width*header.atlas_height*2;
+  if (header.magic != UI_FONT_CACHE_MAGIC || header.version != UI_FONT_CACHE_VERSION) nob_return_defer(false);
+  if ((int)header.size != uf->size || header.glyph_count == 0) nob_return_defer(false);
+  if (mf.size != sizeof(header) + glyphs_size + atlas_size) nob_return_defer(false);
+
+  const Ui_Font_Cache_Glyph *cached = (const Ui_Font_Cache_Glyph *)((const char *)mf.data + sizeof(header));
+  Image atlas = {
+    .data = (char *)mf.data + sizeof(header) + glyphs_size,
+    .width = header.atlas_width,
+    .height = header.atlas_height,
+    .mipmaps = 1,
+    .format = PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA,
+  };
+
+  GlyphInfo *glyphs = calloc(header.glyph_count, sizeof(GlyphInfo));
+  Rectangle *recs = calloc(header.glyph_count, sizeof(Rectangle));
+  for (uint32_t i = 0; i < header.glyph_count; ++i) {
+    recs[i] = (Rectangle) { cached[i].x, cached[i].y, cached[i].width, cached[i].height };
+    glyphs[i] = (GlyphInfo) {
+      .value = cached[i].value, .offsetX = cached[i].offset_x, .offsetY = cached[i].offset_y,
+      .advanceX = cached[i].advance_x,
+      // Kept around so the atlas can be generated again when it has to grow
+      .image = ui_font_glyph_from_atlas(atlas, recs[i]),
+    };
+  }
+
+  uf->font = (Font) {
+    .baseSize = uf->size,
+    .glyphCount = header.glyph_count,
+    .glyphPadding = UI_FONT_GLYPH_PADDING,
+    .texture = LoadTextureFromImage(atlas),
+    .recs = recs,
+    .glyphs = glyphs,
+  };
+  SetTextureFilter(uf->font.texture, TEXTURE_FILTER_BILINEAR);
+  uf->loaded = true;
+  uf->codepoints.count = 0;
+  for (uint32_t i = 0; i < header.glyph_count; ++i) nob_da_append(&uf->codepoints, glyphs[i].value);
+  qsort(uf->codepoints.items, uf->codepoints.count, sizeof(int), compare_ints);
+
+defer:
+  unmap_file(&mf);
+  return result;
+}
+
+// Needs the window to be open already
+void ui_font_init(Ui_Font *uf, int size, const char *cache_dir) {
+  *uf = (Ui_Font) { .font = GetFontDefault(), .size = size };
+
+  const char *path = getenv("LZUA_FONT");
+  for (size_t i = 0; !path && i < NOB_ARRAY_LEN(ui_font_candidates); ++i) {
+    if (nob_file_exists(ui_font_candidates[i]) == 1) path = ui_font_candidates[i];
+  }
+  if (!path || !nob_read_entire_file(path, &uf->file)) {
+    nob_log(NOB_WARNING, "No usable TTF font found, titles are limited to what the default font can draw");
+    return;
+  }
+  nob_log(NOB_INFO, "Using font: %s", path);
+
+  // The cache is keyed by the mtime of the font, without one it could load the atlas of an older version of the file
+  struct stat st = {0};
+  if (cache_dir && stat(path, &st) < 0) {
+    nob_log(NOB_WARNING, "Could not stat %s, rasterizing its glyphs without the cache", path);
+  } else if (cache_dir) {
+    uint64_t key = hash_cstr(path);
+    key = (key ^ (uint64_t)st.st_mtime)*1099511628211ULL;
+    key = (key ^ (uint64_t)size)*1099511628211ULL;
+    Nob_String_Builder sb = {0};
+    nob_sb_appendf(&sb, "%s%cfont-%016llx.bin", cache_dir, PATH_DELIM, (unsigned long long)key);
+    nob_sb_append_null(&sb);
+    uf->cache_path = sb.items;
+    ui_font_load_cache(uf);
+  }
+}
+
+// Rasterizes whatever codepoints the catalog uses that the font does not have yet. Returns true when the font changed
+bool ui_font_sync(Ui_Font *uf, const Games *games) {
+  if (uf->file.count == 0 || uf->catalog_version == games->version) return false;
+  uf->catalog_version = games->version;
+
+  Codepoints missing = {0};
+  // The printable ASCII range always goes in so the glyphs every title is likely to need are there from the start
+  for (int c = 32; c < 127; ++c) {
+    if (!codepoints_contains(&uf->codepoints, c)) nob_da_append(&missing, c);
+  }
+  nob_da_foreach(Game, game, games) {
+    const char *title = game_title(game);
+    for (const char *c = title; *c;) {
+      int size = 0;
+      int codepoint = GetCodepointNext(c, &size);
+      c += size;
+      if (codepoint >= 127 && !codepoints_contains(&uf->codepoints, codepoint)) nob_da_append(&missing, codepoint);
+    }
+  }
+  if (missing.count == 0) return false;
+
+  qsort(missing.items, missing.count, sizeof(int), compare_ints);
+  size_t unique = 0;
+  for (size_t i = 0; i < missing.count; ++i) {
+    if (unique == 0 || missing.items[unique - 1] != missing.items[i]) missing.items[unique++] = missing.items[i];
+  }
+  missing.count = unique;
+
+  GlyphInfo *fresh = LoadFontData((const unsigned char *)uf->file.items, (int)uf->file.count, uf->size,
+                                  missing.items, (int)missing.count, FONT_DEFAULT);
+  if (!fresh) {
+    nob_log(NOB_ERROR, "Could not rasterize %zu new glyphs", missing.count);
+    free(missing.items);
+    return false;
+  }
+
+  int old_count = uf->loaded ? uf->font.glyphCount : 0;
+  GlyphInfo *glyphs = malloc(sizeof(GlyphInfo)*(old_count + missing.count));
+  NOB_ASSERT(glyphs != NULL && "Buy more RAM lol");
+  if (old_count > 0) memcpy(glyphs, uf->font.glyphs, sizeof(GlyphInfo)*old_count);
+  memcpy(glyphs + old_count, fresh, sizeof(GlyphInfo)*missing.count);
+  if (uf->loaded) free(uf->font.glyphs);
+  free(fresh);
+
+  nob_log(NOB_INFO, "Rasterized %zu new glyphs for the titles", missing.count);
+  ui_font_replace_glyphs(uf, glyphs, old_count + (int)missing.count);
+  free(missing.items);
+  return true;
+}
+
+void ui_font_free(Ui_Font *uf) {
+  if (uf->loaded) UnloadFont(uf->font);
+  free(uf->file.items);
+  free(uf->codepoints.items);
+  free(uf->cache_path);
+  *uf = (Ui_Font) {0};
+}
+
+// Width of the title of a game of the catalog and what it was measured for. Titles are interned so comparing the
+// pointer is enough. Kept by catalog index and not by tile so filtering the view doesn't measure everything again
+typedef struct {
+  int width;
+  const char *title;
+  unsigned int font_id;
+  int font_size;
+} Title_Measure;
+
+typedef List(Title_Measure) Title_Measures;
+
+typedef struct {
+  Title_Measure *measures;
+  size_t *stale;
+  Font font;
+  int font_size;
+} Measure_Titles_Ctx;
+
+// Only reads the glyph data of the font, so it is fine to run from several threads at once
+void measure_titles_chunk(void *arg, size_t begin, size_t end) {
+  Measure_Titles_Ctx *ctx = arg;
+  for (size_t i = begin; i < end; ++i) {
+    Title_Measure *tm = &ctx->measures[ctx->stale[i]];
+    tm->width = measure_title(ctx->font, tm->title, ctx->font_size);
+  }
+}
+
+#define MEASURE_TITLES_MIN_CHUNK 1024
+
+void calculate_game_buttons_positions(Rectangle bounds, Games games, Game_View view, GameButton *buttons, size_t count, Title_Measures *measures, Layout_Rows *rows, Font font, int font_size) {
+  size_t old_count = measures->count;
+  nob_da_resize(measures, games.count);
+  if (games.count > old_count) {
+    memset(measures->items + old_count, 0, sizeof(Title_Measure)*(games.count - old_count));
+  }
+
+  size_t save = nob_temp_save();
+  size_t *stale = nob_temp_alloc(sizeof(size_t)*count);
+  size_t stale_count = 0;
+
+  for (size_t i = 0; i < count; ++i) {
+    GameButton *gb = &buttons[i];
+    gb->game_index = view.items ? view.items[i] : i;
+    gb->data = games.items[gb->game_index];
+    Title_Measure *tm = &measures->items[gb->game_index];
+    const char *title = game_title(&gb->data);
+    if (tm->title == title && tm->font_id == font.texture.id && tm->font_size == font_size) continue;
+    tm->title = title;
+    tm->font_id = font.texture.id;
+    tm->font_size = font_size;
+    stale[stale_count++] = gb->game_index;
+  }
+
+  if (stale_count > 0) {
+    Measure_Titles_Ctx ctx = { .measures = measures->items, .stale = stale, .font = font, .font_size = font_size };
+    parallel_for(stale_count, MEASURE_TITLES_MIN_CHUNK, measure_titles_chunk, &ctx);
+  }
+  nob_temp_rewind(save);
+
+  for (GameButton *gb = buttons; gb < buttons + count; ++gb) {
+    gb->title_width = measures->items[gb->game_index].width;
+    gb->width = MAX(GAME_BUTTON_HEIGHT, gb->title_width + GENERAL_PADDING*2);
+    gb->height = GAME_BUTTON_HEIGHT;
+  }
+
+  pack_game_buttons_rows(bounds, buttons, count, rows);
+}
+
+typedef enum {
+  NAV_UP,
+  NAV_DOWN,
+  NAV_LEFT,
+  NAV_RIGHT,
+  NAV_DIRECTION_COUNT,
+} Nav_Direction;
+
+#define NAV_NONE SIZE_MAX
+
+// Where each direction goes from a button, as positions in the layout
+typedef struct {
+  size_t to[NAV_DIRECTION_COUNT];
+} Nav_Links;
+
+typedef List(Nav_Links) Nav_Graph;
+
+// Everything the positions of the buttons depend on. If none of it changed there is no reason to lay them out again
+typedef struct {
+  Rectangle bounds;
+  size_t catalog_version;
+  size_t view_version;
+  unsigned int font_id;
+  int font_size;
+} Layout_Key;
+
+typedef struct {
+  GameButton *items;
+  size_t count;
+  size_t capacity;
+  Layout_Rows rows;
+  Title_Measures measures;
+  // Same positions as items
+  Nav_Graph links;
+  Layout_Key key;
+  bool valid;
+} Layout;
+
+// Links every button of a row to the button of the other row it overlaps the most horizontally, or the closest
+// one when it overlaps none. Both rows are sorted by x and the buttons of a row don't overlap each other, so
+// whatever overlaps a button starts at or after whatever overlapped the one before
+void layout_link_rows(Layout *layout, Layout_Row from, Layout_Row to, Nav_Direction direction) {
+  size_t j = to.start, to_end = to.start + to.count;
+  for (size_t i = from.start; i < from.start + from.count; ++i) {
+    const GameButton *a = &layout->items[i];
+    while (j < to_end && layout->items[j].x + layout->items[j].width <= a->x) j += 1;
+
+    size_t best = NAV_NONE;
+    float best_overlap = 0;
+    for (size_t k = j; k < to_end && layout->items[k].x < a->x + a->width; ++k) {
+      const GameButton *b = &layout->items[k];
+      float overlap = MIN(a->x + a->width, b->x + b->width) - MAX(a->x, b->x);
+      if (overlap > best_overlap) {
+        best = k;
+        best_overlap = overlap;
+      }
+    }
+    if (best == NAV_NONE) {
+      // In a gap of the other row, or past one of its ends
+      float center = a->x + a->width/2;
+      float best_distance = INFINITY;
+      for (size_t k = j > to.start ? j - 1 : j; k < MIN(j + 1, to_end); ++k) {
+        const GameButton *b = &layout->items[k];
+        float distance = fabsf(b->x + b->width/2 - center);
+        if (distance < best_distance) {
+          best = k;
+          best_distance = distance;
+        }
+      }
+    }
+    layout->links.items[i].to[direction] = best;
+  }
+}
+
+// Done once per layout so moving the focus is just following a link
+void layout_link_neighbours(Layout *layout) {
+  nob_da_resize(&layout->links, layout->count);
+  for (size_t i = 0; i < layout->count; ++i) {
+    // Left and right go on to the next row like reading does
+    layout->links.items[i] = (Nav_Links) {
+      .to = {
+        [NAV_UP] = NAV_NONE,
+        [NAV_DOWN] = NAV_NONE,
+        [NAV_LEFT] = i > 0 ? i - 1 : NAV_NONE,
+        [NAV_RIGHT] = i + 1 < layout->count ? i + 1 : NAV_NONE,
+      },
+    };
+  }
+  for (size_t r = 0; r + 1 < layout->rows.count; ++r) {
+    layout_link_rows(layout, layout->rows.items[r], layout->rows.items[r + 1], NAV_DOWN);
+    layout_link_rows(layout, layout->rows.items[r + 1], layout->rows.items[r], NAV_UP);
+  }
+}
+
+bool layout_key_eq(Layout_Key a, Layout_Key b) {
+  return a.bounds.x == b.bounds.x && a.bounds.y == b.bounds.y
+    && a.bounds.width == b.bounds.width && a.bounds.height == b.bounds.height
+    && a.catalog_version == b.catalog_version && a.view_version == b.view_version
+    && a.font_id == b.font_id && a.font_size == b.font_size;
+}
+
+// Returns true when the layout had to be recomputed
+bool layout_update(Layout *layout, Rectangle bounds, Games games, Game_View view, Font font, int font_size) {
+  Layout_Key key = {
+    .bounds = bounds,
+    .catalog_version = games.version,
+    .view_version = view.version,
+    .font_id = font.texture.id,
+    .font_size = font_size,
+  };
+  if (layout->valid && layout_key_eq(layout->key, key)) return false;
+
+  size_t count = view.items ? view.count : games.count;
+  nob_da_resize(layout, count);
+  calculate_game_buttons_positions(bounds, games, view, layout->items, count, &layout->measures, &layout->rows, font, font_size);
+  layout_link_neighbours(layout);
+  layout->key = key;
+  layout->valid = true;
+  return true;
+}
+
+float layout_content_height(const Layout *layout) {
+  if (layout->rows.count == 0) return 0;
+  Layout_Row last = layout->rows.items[layout->rows.count - 1];
+  return last.y + GAME_BUTTON_HEIGHT + GENERAL_PADDING - layout->key.bounds.y;
+}
+
+// Index of the first row that still reaches y, rows are sorted by their y so it is just a binary search
+size_t layout_first_row_reaching(const Layout *layout, float y) {
+  size_t lo = 0, hi = layout->rows.count;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo)/2;
+    if (layout->rows.items[mid].y + GAME_BUTTON_HEIGHT < y) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+
+static inline char fold_ascii(char c) {
+  return ('A' <= c && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+// Substring search over text that is already case folded, the query is folded once and the texts when they are
+// packed, so the kernels only compare bytes. The vector kernels test every position of a block at once against the
+// first and last byte of the needle and only compare the rest where both match. They read up to SUBSTRING_PADDING
+// bytes past the end of the haystack, callers have to make sure those are there
+#define SUBSTRING_NOT_FOUND ((size_t)-1)
+#define SUBSTRING_PADDING 32
+
+typedef size_t (*Substring_Find_Func)(const char *hay, size_t len, const char *needle, size_t needle_len);
+
+// The reference every other kernel has to agree with
+size_t substring_find_scalar(const char *hay, size_t len, const char *needle, size_t needle_len) {
+  if (needle_len == 0) return 0;
+  if (needle_len > len) return SUBSTRING_NOT_FOUND;
+  for (size_t i = 0; i + needle_len <= len; ++i) {
+    if (hay[i] == needle[0] && memcmp(hay + i, needle, needle_len) == 0) return i;
+  }
+  return SUBSTRING_NOT_FOUND;
+}
+
+#if SUBSTRING_SIMD
+static inline int ctz32(uint32_t x) {
+  #ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, x);
+  return (int)index;
+  #else
+  return __builtin_ctz(x);
+  #endif // _MSC_VER
+}
+
+// Only positions that leave room for the whole needle before len count
+static inline uint32_t substring_valid_mask(size_t remaining, int width) {
+  if (remaining >= (size_t)width) return 0xffffffffu;
+  return (1u << remaining) - 1;
+}
+
+size_t substring_find_sse2(const char *hay, size_t len, const char *needle, size_t needle_len) {
+  if (needle_len == 0) return 0;
+  if (needle_len > len) return SUBSTRING_NOT_FOUND;
+  const __m128i first = _mm_set1_epi8(needle[0]);
+  const __m128i last = _mm_set1_epi8(needle[needle_len - 1]);
+  for (size_t i = 0; i + needle_len <= len; i += 16) {
+    __m128i block_first = _mm_loadu_si128((const __m128i *)(hay + i));
+    __m128i block_last = _mm_loadu_si128((const __m128i *)(hay + i + needle_len - 1));
+    __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last));
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(eq) & substring_valid_mask(len - needle_len - i + 1, 16);
+    while (mask) {
+      int k = ctz32(mask);
+      if (needle_len <= 2 || memcmp(hay + i + k + 1, needle + 1, needle_len - 2) == 0) return i + k;
+      mask &= mask - 1;
+    }
+  }
+  return SUBSTRING_NOT_FOUND;
+}
+
+#ifdef _MSC_VER
+#  define TARGET_AVX2
+#else
+#  define TARGET_AVX2 __attribute__((target("avx2")))
+#endif // _MSC_VER
+
+TARGET_AVX2
+size_t substring_find_avx2(const char *hay, size_t len, const char *needle, size_t needle_len) {
+  if (needle_len == 0) return 0;
+  if (needle_len > len) return SUBSTRING_NOT_FOUND;
+  const __m256i first = _mm256_set1_epi8(needle[0]);
+  const __m256i last = _mm256_set1_epi8(needle[needle_len - 1]);
+  for (size_t i = 0; i + needle_len <= len; i += 32) {
+    __m256i block_first = _mm256_loadu_si256((const __m256i *)(hay + i));
+    __m256i block_last = _mm256_loadu_si256((const __m256i *)(hay + i + needle_len - 1));
+    __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last));
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(eq) & substring_valid_mask(len - needle_len - i + 1, 32);
+    while (mask) {
+      int k = ctz32(mask);
+      if (needle_len <= 2 || memcmp(hay + i + k + 1, needle + 1, needle_len - 2) == 0) return i + k;
+      mask &= mask - 1;
+    }
+  }
+  return SUBSTRING_NOT_FOUND;
+}
+
+bool cpu_has_avx2(void) {
+  #ifdef _MSC_VER
+  int regs[4];
+  __cpuid(regs, 1);
+  bool osxsave = regs[2] & (1 << 27);
+  bool avx = regs[2] & (1 << 28);
+  // The OS has to be saving the ymm registers too, not just the CPU having them
+  if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+  __cpuidex(regs, 7, 0);
+  return regs[1] & (1 << 5);
+  #else
+  return __builtin_cpu_supports("avx2");
+  #endif // _MSC_VER
+}
+#endif // SUBSTRING_SIMD
+
+static Substring_Find_Func substring_find_kernel = substring_find_scalar;
+
+void substring_select_kernel(void) {
+  const char *name = "scalar";
+  #if SUBSTRING_SIMD
+  // SSE2 is part of x86_64 so it is always there
+  substring_find_kernel = substring_find_sse2;
+  name = "SSE2";
+  if (cpu_has_avx2()) {
+    substring_find_kernel = substring_find_avx2;
+    name = "AVX2";
+  }
+  #endif // SUBSTRING_SIMD
+  nob_log(NOB_INFO, "Substring search kernel: %s", name);
+}
+
+size_t substring_find(const char *hay, size_t len, const char *needle, size_t needle_len) {
+  size_t found = substring_find_kernel(hay, len, needle, needle_len);
+  #ifdef BUILD_DEBUG
+  // Differential check of whatever kernel got picked against the reference, debug builds only
+  NOB_ASSERT(found == substring_find_scalar(hay, len, needle, needle_len) && "Substring kernel disagrees with the scalar one");
+  #endif // BUILD_DEBUG
+  return found;
+}
+
+
+// Trigram index over the name, alias and executable of every game of the catalog, for substring queries. The folder
+// of a game is the games directory plus its name, so the name already covers it. Posting lists are sorted by catalog
+// index so they intersect with a merge. It lives next to the games as TRIGRAMS_FILE so the next start doesn't index
+// everything again, only what changed since
+#define TRIGRAMS_FILE ".lzua.trigrams"
+#define TRIGRAMS_MAGIC 0x4952544c // "LTRI"
+#define TRIGRAMS_VERSION 1
+
+typedef List(uint32_t) Trigram_Keys;
+
+typedef struct {
+  // Folded bytes, never zero since the texts are C strings
+  uint32_t key;
+  uint32_t count;
+  uint32_t capacity;
+  uint32_t *docs;
+} Trigram_Posting;
+
+typedef struct {
+  // What the trigrams were taken from, to tell when the game changed
+  uint64_t hash;
+  // Unique, needed to take the game out of its postings again
+  Trigram_Keys keys;
+} Trigram_Doc;
+
+typedef struct {
+  // Open addressing by key, capacity is a power of two
+  Trigram_Posting *postings;
+  size_t postings_count;
+  size_t postings_capacity;
+  List(Trigram_Doc) docs;
+  size_t catalog_version;
+  size_t posting_entries;
+  bool synced;
+  bool dirty;
+} Trigram_Index;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t doc_count;
+  uint32_t posting_count;
+  uint64_t entry_count;
+} Trigram_File_Header;
+
+typedef struct {
+  uint32_t key;
+  uint32_t count;
+} Trigram_File_Posting;
+
+static inline uint32_t trigram_key(const char *text) {
+  return ((uint32_t)(unsigned char)fold_ascii(text[0]) << 16)
+    | ((uint32_t)(unsigned char)fold_ascii(text[1]) << 8)
+    | (uint32_t)(unsigned char)fold_ascii(text[2]);
+}
+
+static inline size_t trigram_hash_key(uint32_t key) {
+  return (size_t)((key*2654435761u) ^ (key >> 15));
+}
+
+int compare_u32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+  return (x > y) - (x < y);
+}
+
+void trigram_collect_text(const char *text, Trigram_Keys *keys) {
+  if (!text) return;
+  size_t len = strlen(text);
+  for (size_t i = 0; i + 3 <= len; ++i) nob_da_append(keys, trigram_key(text + i));
+}
+
+void trigram_collect(const Game *game, Trigram_Keys *keys) {
+  keys->count = 0;
+  trigram_collect_text(game->name, keys);
+  trigram_collect_text(game->alias, keys);
+  trigram_collect_text(game->exe, keys);
+  if (keys->count == 0) return;
+  qsort(keys->items, keys->count, sizeof(uint32_t), compare_u32);
+  size_t unique = 1;
+  for (size_t i = 1; i < keys->count; ++i) {
+    if (keys->items[i] != keys->items[unique - 1]) keys->items[unique++] = keys->items[i];
+  }
+  keys->count = unique;
+}
+
+uint64_t trigram_game_hash(const Game *game) {
+  uint64_t hash = hash_cstr(game->name);
+  hash = (hash ^ (game->alias ? hash_cstr(game->alias) : 0))*1099511628211ULL;
+  hash = (hash ^ (game->exe ? hash_cstr(game->exe) : 0))*1099511628211ULL;
+  return hash;
+}
+
+Trigram_Posting *trigram_find(const Trigram_Index *index, uint32_t key) {
+  if (index->postings_capacity == 0) return NULL;
+  size_t mask = index->postings_capacity - 1;
+  for (size_t i = trigram_hash_key(key) & mask;; i = (i + 1) & mask) {
+    Trigram_Posting *posting = &index->postings[i];
+    if (posting->key == key) return posting;
+    if (posting->key == 0) return NULL;
+  }
+}
+
+Trigram_Posting *trigram_find_or_add(Trigram_Index *index, uint32_t key) {
+  if ((index->postings_count + 1)*2 > index->postings_capacity) {
+    size_t capacity = index->postings_capacity ? index->postings_capacity*2 : 1024;
+    Trigram_Posting *postings = calloc(capacity, sizeof(*postings));
+    NOB_ASSERT(postings != NULL && "Buy more RAM lol");
+    for (size_t i = 0; i < index->postings_capacity; ++i) {
+      Trigram_Posting it = index->postings[i];
+      if (it.key == 0) continue;
+      size_t j = trigram_hash_key(it.key) & (capacity - 1);
+      while (postings[j].key) j = (j + 1) & (capacity - 1);
+      postings[j] = it;
+    }
+    free(index->postings);
+    index->postings = postings;
+    index->postings_capacity = capacity;
+  }
+
+  size_t mask = index->postings_capacity - 1;
+  size_t i = trigram_hash_key(key) & mask;
+  while (index->postings[i].key && index->postings[i].key != key) i = (i + 1) & mask;
+  Trigram_Posting *posting = &index->postings[i];
+  if (posting->key == 0) {
+    posting->key = key;
+    index->postings_count += 1;
+  }
+  return posting;
+}
+
+// Postings are sorted, documents mostly come in order so appending is the common case
+void trigram_posting_insert(Trigram_Posting *posting, uint32_t doc) {
+  if (posting->count == posting->capacity) {
+    posting->capacity = posting->capacity ? posting->capacity*2 : 4;
+    posting->docs = realloc(posting->docs, sizeof(uint32_t)*posting->capacity);
+    NOB_ASSERT(posting->docs != NULL && "Buy more RAM lol");
+  }
+  uint32_t at = posting->count;
+  if (at > 0 && posting->docs[at - 1] >= doc) {
+    uint32_t lo = 0, hi = posting->count;
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo)/2;
+      if (posting->docs[mid] < doc) lo = mid + 1;
+      else hi = mid;
+    }
+    if (lo < posting->count && posting->docs[lo] == doc) return;
+    at = lo;
+  }
+  memmove(posting->docs + at + 1, posting->docs + at, sizeof(uint32_t)*(posting->count - at));
+  posting->docs[at] = doc;
+  posting->count += 1;
+}
+
+bool trigram_posting_remove(Trigram_Posting *posting, uint32_t doc) {
+  uint32_t lo = 0, hi = posting->count;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo)/2;
+    if (posting->docs[mid] < doc) lo = mid + 1;
+    else hi = mid;
+  }
+  if (lo == posting->count || posting->docs[lo] != doc) return false;
+  memmove(posting->docs + lo, posting->docs + lo + 1, sizeof(uint32_t)*(posting->count - lo - 1));
+  posting->count -= 1;
+  return true;
+}
+
+// Empty postings stay in the table, a game with the same trigram comes back soon enough
+void trigram_doc_unindex(Trigram_Index *index, uint32_t doc) {
+  Trigram_Doc *d = &index->docs.items[doc];
+  for (size_t i = 0; i < d->keys.count; ++i) {
+    Trigram_Posting *posting = trigram_find(index, d->keys.items[i]);
+    if (posting && trigram_posting_remove(posting, doc)) index->posting_entries -= 1;
+  }
+  d->keys.count = 0;
+  d->hash = 0;
+}
+
+void trigram_doc_index(Trigram_Index *index, uint32_t doc, const Game *game) {
+  // Collected in a shared buffer and copied out at their exact size, a list per game growing on its own would
+  // take several times the memory of the keys themselves
+  static Trigram_Keys scratch = {0};
+  trigram_collect(game, &scratch);
+  Trigram_Doc *d = &index->docs.items[doc];
+  if (d->keys.capacity < scratch.count) {
+    d->keys.capacity = scratch.count;
+    d->keys.items = realloc(d->keys.items, sizeof(uint32_t)*d->keys.capacity);
+    NOB_ASSERT(d->keys.items != NULL && "Buy more RAM lol");
+  }
+  if (scratch.count > 0) memcpy(d->keys.items, scratch.items, sizeof(uint32_t)*scratch.count);
+  d->keys.count = scratch.count;
+  d->hash = trigram_game_hash(game);
+  for (size_t i = 0; i < d->keys.count; ++i) {
+    trigram_posting_insert(trigram_find_or_add(index, d->keys.items[i]), doc);
+    index->posting_entries += 1;
+  }
+}
+
+// Brings the index up to date with the catalog, only games whose texts changed are indexed again. Returns true when
+// anything changed
+bool trigram_index_sync(Trigram_Index *index, const Games *games) {
+  if (index->synced && index->catalog_version == games->version) return false;
+  index->synced = true;
+  index->catalog_version = games->version;
+
+  bool changed = false;
+  for (size_t doc = games->count; doc < index->docs.count; ++doc) {
+    trigram_doc_unindex(index, doc);
+    free(index->docs.items[doc].keys.items);
+    changed = true;
+  }
+  size_t old_count = MIN(index->docs.count, games->count);
+  nob_da_resize(&index->docs, games->count);
+  for (size_t doc = old_count; doc < games->count; ++doc) index->docs.items[doc] = (Trigram_Doc) {0};
+
+  for (size_t doc = 0; doc < games->count; ++doc) {
+    const Game *game = &games->items[doc];
+    Trigram_Doc *d = &index->docs.items[doc];
+    if (doc < old_count && d->hash == trigram_game_hash(game)) continue;
+    if (doc < old_count) trigram_doc_unindex(index, doc);
+    trigram_doc_index(index, doc, game);
+    changed = true;
+  }
+  if (changed) index->dirty = true;
+  return changed;
+}
+
+int compare_posting_sizes(const void *a, const void *b) {
+  uint32_t x = (*(Trigram_Posting *const *)a)->count, y = (*(Trigram_Posting *const *)b)->count;
+  return (x > y) - (x < y);
+}
+
+// Games that have every trigram of the pattern, sorted by catalog index. These still have to be checked for the
+// pattern itself. Only meaningful for patterns of 3 bytes or more
+void trigram_index_query(const Trigram_Index *index, const char *pattern, size_t len, Game_Indices *out) {
+  out->count = 0;
+  if (len < 3) return;
+
+  size_t save = nob_temp_save();
+  size_t count = len - 2;
+  Trigram_Posting **postings = nob_temp_alloc(sizeof(*postings)*count);
+  for (size_t i = 0; i < count; ++i) {
+    postings[i] = trigram_find(index, trigram_key(pattern + i));
+    if (!postings[i] || postings[i]->count == 0) {
+      nob_temp_rewind(save);
+      return;
+    }
+  }
+  // Starting from the shortest list keeps every intersection after it short too
+  qsort(postings, count, sizeof(*postings), compare_posting_sizes);
+
+  const Trigram_Posting *first = postings[0];
+  for (size_t i = 0; i < first->count; ++i) nob_da_append(out, first->docs[i]);
+  for (size_t p = 1; p < count && out->count > 0; ++p) {
+    if (postings[p] == postings[p - 1]) continue;
+    const Trigram_Posting *posting = postings[p];
+    size_t kept = 0, j = 0;
+    for (size_t i = 0; i < out->count; ++i) {
+      while (j < posting->count && posting->docs[j] < out->items[i]) j += 1;
+      if (j == posting->count) break;
+      if (posting->docs[j] == out->items[i]) out->items[kept++] = out->items[i];
+    }
+    out->count = kept;
+  }
+  nob_temp_rewind(save);
+}
+
+size_t trigram_index_memory(const Trigram_Index *index) {
+  size_t bytes = sizeof(Trigram_Posting)*index->postings_capacity + sizeof(Trigram_Doc)*index->docs.capacity;
+  for (size_t i = 0; i < index->postings_capacity; ++i) bytes += sizeof(uint32_t)*index->postings[i].capacity;
+  for (size_t i = 0; i < index->docs.count; ++i) bytes += sizeof(uint32_t)*index->docs.items[i].keys.capacity;
+  return bytes;
+}
+
+void trigram_index_log_stats(const Trigram_Index *index) {
+  size_t bytes = trigram_index_memory(index);
+  size_t games = index->docs.count;
+  nob_log(NOB_INFO, "Trigram index: %zu games, %zu trigrams, %zu postings, %.1f KiB (%zu bytes per game)",
+          games, index->postings_count, index->posting_entries, bytes/1024.0, games ? bytes/games : 0);
+}
+
+bool trigram_index_save(const Trigram_Index *index, const char *path) {
+  Trigram_File_Header header = {
+    .magic = TRIGRAMS_MAGIC,
+    .version = TRIGRAMS_VERSION,
+    .doc_count = (uint32_t)index->docs.count,
+    .entry_count = index->posting_entries,
+  };
+  Nob_String_Builder sb = {0};
+  nob_sb_append_buf(&sb, (const char *)&header, sizeof(header));
+  for (size_t i = 0; i < index->docs.count; ++i) {
+    nob_sb_append_buf(&sb, (const char *)&index->docs.items[i].hash, sizeof(uint64_t));
+  }
+  for (size_t i = 0; i < index->postings_capacity; ++i) {
+    const Trigram_Posting *posting = &index->postings[i];
+    if (posting->key == 0 || posting->count == 0) continue;
+    Trigram_File_Posting fp = { .key = posting->key, .count = posting->count };
+    nob_sb_append_buf(&sb, (const char *)&fp, sizeof(fp));
+    nob_sb_append_buf(&sb, (const char *)posting->docs, sizeof(uint32_t)*posting->count);
+    header.posting_count += 1;
+  }
+  memcpy(sb.items, &header, sizeof(header));
+
+  bool result = replace_file(path, sb.items, sb.count);
+  free(sb.items);
+  return result;
+}
+
+void trigram_index_free(Trigram_Index *index) {
+  for (size_t i = 0; i < index->postings_capacity; ++i) free(index->postings[i].docs);
+  free(index->postings);
+  for (size_t i = 0; i < index->docs.count; ++i) free(index->docs.items[i].keys.items);
+  free(index->docs.items);
+  *index = (Trigram_Index) {0};
+}
+
+// Loads what the last run saved. The per game lists of trigrams are not stored, they come back from the postings
+bool trigram_index_load(Trigram_Index *index, const char *path) {
+  bool result = true;
+  Mapped_File mf = {0};
+  if (!map_file(path, &mf)) return false;
+
+  Trigram_File_Header header = {0};
+  if (mf.size < sizeof(header)) nob_return_defer(false);
+  memcpy(&header, mf.data, sizeof(header));
+  if (header.magic != TRIGRAMS_MAGIC || header.version != TRIGRAMS_VERSION) nob_return_defer(false);
+
+  const char *cursor = (const char *)mf.data + sizeof(header);
+  const char *end = (const char *)mf.data + mf.size;
+  if ((size_t)(end - cursor) < sizeof(uint64_t)*header.doc_count) nob_return_defer(false);
+  nob_da_resize(&index->docs, header.doc_count);
+  for (size_t i = 0; i < header.doc_count; ++i) {
+    index->docs.items[i] = (Trigram_Doc) {0};
+    memcpy(&index->docs.items[i].hash, cursor, sizeof(uint64_t));
+    cursor += sizeof(uint64_t);
+  }
+
+  for (uint32_t p = 0; p < header.posting_count; ++p) {
+    Trigram_File_Posting fp = {0};
+    if ((size_t)(end - cursor) < sizeof(fp)) nob_return_defer(false);
+    memcpy(&fp, cursor, sizeof(fp));
+    cursor += sizeof(fp);
+    if (fp.key == 0 || (size_t)(end - cursor) < sizeof(uint32_t)*fp.count) nob_return_defer(false);
+
+    Trigram_Posting *posting = trigram_find_or_add(index, fp.key);
+    posting->docs = realloc(posting->docs, sizeof(uint32_t)*fp.count);
+    NOB_ASSERT(posting->docs != NULL && "Buy more RAM lol");
+    memcpy(posting->docs, cursor, sizeof(uint32_t)*fp.count);
+    posting->count = posting->capacity = fp.count;
+    cursor += sizeof(uint32_t)*fp.count;
+    for (uint32_t i = 0; i < fp.count; ++i) {
+      uint32_t doc = posting->docs[i];
+      if (doc >= header.doc_count || (i > 0 && posting->docs[i - 1] >= doc)) nob_return_defer(false);
+      index->docs.items[doc].keys.capacity += 1;
+    }
+    index->posting_entries += fp.count;
+  }
+
+  // Counted first so every game gets its keys at their exact size
+  for (size_t i = 0; i < index->docs.count; ++i) {
+    Trigram_Keys *keys = &index->docs.items[i].keys;
+    if (keys->capacity == 0) continue;
+    keys->items = malloc(sizeof(uint32_t)*keys->capacity);
+    NOB_ASSERT(keys->items != NULL && "Buy more RAM lol");
+  }
+  for (size_t i = 0; i < index->postings_capacity; ++i) {
+    const Trigram_Posting *posting = &index->postings[i];
+    for (uint32_t j = 0; j < posting->count; ++j) {
+      Trigram_Keys *keys = &index->docs.items[posting->docs[j]].keys;
+      keys->items[keys->count++] = posting->key;
+    }
+  }
+
+defer:
+  unmap_file(&mf);
+  if (!result) {
+    nob_log(NOB_WARNING, "Ignoring invalid trigram index %s", path);
+    trigram_index_free(index);
+  }
+  return result;
+}
+
+// Type to search. Matching is a fuzzy subsequence match, so every result of a query is also a result of any query it
+// starts with. Typing a character then only has to go through the results of the query before it, and since each
+// level of the query keeps its results around, backspace just pops a level. A query starting with SEARCH_EXACT_PREFIX
+// looks for the rest as a substring instead, also in the executables, which holds up the same way and can use the
+// trigram index
+#define SEARCH_MAX_SCORE 256
+#define SEARCH_EXACT_PREFIX '\''
+// Exact levels scan the whole name blob while the level below still has more than this fraction of the catalog
+#define SEARCH_SCAN_FRACTION 4
+#define SEARCH_BAR_HEIGHT 30
+#define SEARCH_FONT_SIZE 20
+
+// Where the greedy match of the query in one text is at. Greedy matching never looks back, so a longer query picks up
+// from here instead of going through the text again
+typedef struct {
+  // Offset to look for the next character from, negative once the text stopped matching
+  int next;
+  int first;
+  int last;
+  int score;
+} Fuzzy_State;
+
+#define FUZZY_START ((Fuzzy_State) { .next = 0, .first = -1, .last = -2 })
+#define FUZZY_FAILED ((Fuzzy_State) { .next = -1 })
+
+typedef struct {
+  size_t index;
+  Fuzzy_State name;
+  Fuzzy_State alias;
+  int score;
+} Search_Hit;
+
+typedef List(Search_Hit) Search_Hits;
+
+typedef struct {
+  // Bytes of the query this level matched
+  size_t query_len;
+  // In catalog order, sorting by score happens on the view
+  Search_Hits hits;
+} Search_Level;
+
+typedef enum {
+  NAME_BLOB_NAME,
+  NAME_BLOB_ALIAS,
+  NAME_BLOB_EXE,
+  NAME_BLOB_FIELDS,
+} Name_Blob_Field;
+
+typedef struct {
+  uint32_t offset[NAME_BLOB_FIELDS];
+  uint32_t length[NAME_BLOB_FIELDS];
+} Name_Blob_Entry;
+
+// Folded copies of the texts of every game of the catalog back to back, each one ended by a zero byte so no match
+// can run from one into the next. Substring queries go over this instead of chasing a pointer per game, and it ends
+// in SUBSTRING_PADDING zeros so the kernels can read past the last text
+typedef struct {
+  Nob_String_Builder bytes;
+  size_t len;
+  List(Name_Blob_Entry) entries;
+} Name_Blob;
+
+void name_blob_build(Name_Blob *blob, const Games *games) {
+  blob->bytes.count = 0;
+  blob->entries.count = 0;
+  for (size_t i = 0; i < games->count; ++i) {
+    const Game *game = &games->items[i];
+    const char *texts[NAME_BLOB_FIELDS] = {
+      [NAME_BLOB_NAME] = game->name,
+      [NAME_BLOB_ALIAS] = game->alias,
+      [NAME_BLOB_EXE] = game->exe,
+    };
+    Name_Blob_Entry entry = {0};
+    for (size_t f = 0; f < NAME_BLOB_FIELDS; ++f) {
+      entry.offset[f] = (uint32_t)blob->bytes.count;
+      for (const char *c = texts[f]; c && *c; ++c) nob_da_append(&blob->bytes, fold_ascii(*c));
+      entry.length[f] = (uint32_t)(blob->bytes.count - entry.offset[f]);
+      nob_da_append(&blob->bytes, '\0');
+    }
+    nob_da_append(&blob->entries, entry);
+  }
+  blob->len = blob->bytes.count;
+  nob_da_reserve(&blob->bytes, blob->len + SUBSTRING_PADDING);
+  memset(blob->bytes.items + blob->len, 0, SUBSTRING_PADDING);
+}
+
+// Game the byte at offset belongs to, looking from game onwards. Scans go through the blob in order so walking
+// forward from the last match adds up to a single pass over the games
+size_t name_blob_game_at(const Name_Blob *blob, size_t game, size_t offset) {
+  while (game + 1 < blob->entries.count && blob->entries.items[game + 1].offset[NAME_BLOB_NAME] <= offset) game += 1;
+  return game;
+}
+
+void name_blob_free(Name_Blob *blob) {
+  free(blob->bytes.items);
+  free(blob->entries.items);
+  *blob = (Name_Blob) {0};
+}
+
+typedef struct {
+  Nob_String_Builder query;
+  // Only the first depth levels are in use. The ones after it keep their buffers for the next keystrokes
+  List(Search_Level) levels;
+  size_t depth;
+  Game_Indices order;
+  size_t counts[SEARCH_MAX_SCORE];
+  // Which characters show up in the name or alias of each game of the catalog, see search_char_bit. Lets most games
+  // that can't match be skipped without touching their strings at all
+  List(uint64_t) masks;
+  // Optional, exact queries go through every candidate without it
+  const Trigram_Index *trigrams;
+  Game_Indices candidates;
+  Name_Blob blob;
+  // Folded pattern of an exact query
+  Nob_String_Builder pattern;
+  size_t catalog_version;
+  size_t version;
+} Search;
+
+static inline bool search_is_separator(char c) {
+  return c == ' ' || c == '_' || c == '-' || c == '.' || c == '(' || c == '[';
+}
+
+static inline uint64_t search_char_bit(char c) {
+  unsigned char u = (unsigned char)fold_ascii(c);
+  if ('a' <= u && u <= 'z') return 1ULL << (u - 'a');
+  if ('0' <= u && u <= '9') return 1ULL << (26 + u - '0');
+  return 1ULL << (36 + u%28);
+}
+
+uint64_t search_chars_mask(const char *text, size_t len) {
+  uint64_t mask = 0;
+  for (size_t i = 0; i < len; ++i) mask |= search_char_bit(text[i]);
+  return mask;
+}
+
+uint64_t search_game_mask(const Game *game) {
+  uint64_t mask = search_chars_mask(game->name, strlen(game->name));
+  if (game->alias) mask |= search_chars_mask(game->alias, strlen(game->alias));
+  return mask;
+}
+
+// Matches the next bytes of the query, case insensitive for ASCII. Matches at the start of words and right after the
+// previous match are worth more
+void fuzzy_step(Fuzzy_State *fs, const char *text, const char *bytes, size_t len) {
+  for (size_t i = 0; i < len && fs->next >= 0; ++i) {
+    // Setting the 0x20 bit only turns the upper case of the letter into c, so letters need no folding of the text
+    char c = fold_ascii(bytes[i]);
+    int t = fs->next;
+    char ch;
+    if ('a' <= c && c <= 'z') {
+      while ((ch = text[t]) && (ch | 0x20) != c) t += 1;
+    } else {
+      while ((ch = text[t]) && ch != c) t += 1;
+    }
+    if (!ch) {
+      *fs = FUZZY_FAILED;
+      return;
+    }
+
+    int s = 1;
+    if (t == 0) s += 8;
+    else if (search_is_separator(text[t - 1])) s += 6;
+    else if ('a' <= text[t - 1] && text[t - 1] <= 'z' && 'A' <= text[t] && text[t] <= 'Z') s += 4;
+    if (fs->last == t - 1) s += 5;
+    fs->score += s;
+    if (fs->first < 0) fs->first = t;
+    fs->last = t;
+    fs->next = t + 1;
+  }
+}
+
+// Long gaps between the matched characters take some of the score away. -1 when the text doesn't match
+int fuzzy_score(Fuzzy_State fs, size_t query_len) {
+  if (fs.next < 0) return -1;
+  int gaps = fs.last - fs.first + 1 - (int)query_len;
+  int score = fs.score - MIN(gaps/4, fs.score - 1);
+  return MIN(score, SEARCH_MAX_SCORE - 1);
+}
+
+// Steps a hit by the bytes the query grew by. Returns false when neither the name nor the alias match anymore
+bool search_hit_step(Search_Hit *hit, const Game *game, const char *bytes, size_t len, size_t query_len) {
+  fuzzy_step(&hit->name, game->name, bytes, len);
+  if (game->alias) fuzzy_step(&hit->alias, game->alias, bytes, len);
+  else hit->alias = FUZZY_FAILED;
+  hit->score = MAX(fuzzy_score(hit->name, query_len), fuzzy_score(hit->alias, query_len));
+  return hit->score >= 0;
+}
+
+Game_View search_view(const Search *search) {
+  if (search->depth == 0) return (Game_View) { .version = search->version };
+  return (Game_View) { .items = search->order.items, .count = search->order.count, .version = search->version };
+}
+
+// Orders the hits of the deepest level by score with a counting sort, scores are small so it is linear. Ties stay in
+// catalog order
+void search_order(Search *search) {
+  search->version = game_view_next_version();
+  search->order.count = 0;
+  if (search->depth == 0) return;
+
+  const Search_Hits *hits = &search->levels.items[search->depth - 1].hits;
+  memset(search->counts, 0, sizeof(search->counts));
+  for (size_t i = 0; i < hits->count; ++i) search->counts[SEARCH_MAX_SCORE - 1 - hits->items[i].score] += 1;
+  size_t offset = 0;
+  for (size_t i = 0; i < SEARCH_MAX_SCORE; ++i) {
+    size_t count = search->counts[i];
+    search->counts[i] = offset;
+    offset += count;
+  }
+  nob_da_resize(&search->order, hits->count);
+  for (size_t i = 0; i < hits->count; ++i) {
+    size_t slot = search->counts[SEARCH_MAX_SCORE - 1 - hits->items[i].score]++;
+    search->order.items[slot] = hits->items[i].index;
+  }
+}
+
+// Titles that start with the pattern first, then the ones with a word starting with it. Matching only the executable
+// is the weakest
+int search_exact_field_score(const Search *search, const Name_Blob_Entry *entry, Name_Blob_Field field, size_t at) {
+  if (field == NAME_BLOB_EXE) return 0;
+  const char *text = search->blob.bytes.items + entry->offset[field];
+  return at == 0 ? 3 : search_is_separator(text[at - 1]) ? 2 : 1;
+}
+
+// Scores from the first match of the pattern in the game, which is in the given field since fields are searched
+// in blob order. Only a better alias is left to look for
+int search_exact_score_from(const Search *search, size_t index, Name_Blob_Field field, size_t at, const char *pattern, size_t len) {
+  const Name_Blob_Entry *entry = &search->blob.entries.items[index];
+  int score = search_exact_field_score(search, entry, field, at);
+  if (field == NAME_BLOB_NAME && score < 3) {
+    const char *alias = search->blob.bytes.items + entry->offset[NAME_BLOB_ALIAS];
+    size_t alias_at = substring_find(alias, entry->length[NAME_BLOB_ALIAS], pattern, len);
+    if (alias_at != SUBSTRING_NOT_FOUND) score = MAX(score, search_exact_field_score(search, entry, NAME_BLOB_ALIAS, alias_at));
+  }
+  return score;
+}
+
+int search_exact_score(const Search *search, size_t index, const char *pattern, size_t len) {
+  const Name_Blob_Entry *entry = &search->blob.entries.items[index];
+  const char *bytes = search->blob.bytes.items;
+  for (Name_Blob_Field field = 0; field < NAME_BLOB_FIELDS; ++field) {
+    size_t at = substring_find(bytes + entry->offset[field], entry->length[field], pattern, len);
+    if (at != SUBSTRING_NOT_FOUND) return search_exact_score_from(search, index, field, at, pattern, len);
+  }
+  return -1;
+}
+
+bool search_is_exact(const Search *search) {
+  return search->query.count > 0 && search->query.items[0] == SEARCH_EXACT_PREFIX;
+}
+
+static inline bool search_is_field_char(char c) {
+  char f = fold_ascii(c);
+  return ('a' <= f && f <= 'z') || c == '_';
+}
+
+// A query starting with a field and a comparison, like tag:coop or -size>10G, is a filter. Those are matched by
+// filter_view against the metadata of the library and get no levels of their own
+bool search_is_filter(const Search *search) {
+  const char *query = search->query.items;
+  size_t len = search->query.count;
+  size_t at = len > 0 && query[0] == '-' ? 1 : 0;
+  size_t start = at;
+  while (at < len && search_is_field_char(query[at])) at += 1;
+  return at > start && at < len && strchr(":<>=", query[at]) != NULL;
+}
+
+// Exact levels take their candidates from the trigram index once the pattern is long enough, intersected with the
+// level below since both are sorted by catalog index
+void search_push_exact(Search *search, const Games *games, Search_Level *level) {
+  search->pattern.count = 0;
+  for (size_t i = 1; i < search->query.count; ++i) nob_da_append(&search->pattern, fold_ascii(search->query.items[i]));
+  const char *pattern = search->pattern.items;
+  size_t len = search->pattern.count;
+  const Search_Hits *prev = search->depth > 0 ? &search->levels.items[search->depth - 1].hits : NULL;
+  const Trigram_Index *trigrams = search->trigrams;
+  bool indexed = len >= 3 && trigrams && trigrams->synced && trigrams->catalog_version == games->version;
+
+  // An empty pattern is found at the start of every name
+  if (len == 0) {
+    nob_da_reserve(&level->hits, games->count);
+    for (size_t i = 0; i < games->count; ++i) level->hits.items[i] = (Search_Hit) { .index = i, .score = 3 };
+    level->hits.count = games->count;
+    return;
+  }
+
+  // Unless something narrowed it down a lot already, one pass over the whole blob beats going game by game. Every
+  // match jumps straight to the next game that is still a candidate
+  if (!indexed && (!prev || prev->count >= games->count/SEARCH_SCAN_FRACTION)) {
+    const Name_Blob *blob = &search->blob;
+    nob_da_reserve(&level->hits, prev ? prev->count : games->count);
+    size_t at = prev && prev->count > 0 ? blob->entries.items[prev->items[0].index].offset[NAME_BLOB_NAME] : 0;
+    size_t index = 0;
+    size_t next_prev = 0;
+    while (at < blob->len && (!prev || next_prev < prev->count)) {
+      size_t found = substring_find(blob->bytes.items + at, blob->len - at, pattern, len);
+      if (found == SUBSTRING_NOT_FOUND) break;
+      found += at;
+      index = name_blob_game_at(blob, index, found);
+      if (prev) {
+        while (next_prev < prev->count && prev->items[next_prev].index < index) next_prev += 1;
+        if (next_prev == prev->count) break;
+        if (prev->items[next_prev].index != index) {
+          at = blob->entries.items[prev->items[next_prev].index].offset[NAME_BLOB_NAME];
+          continue;
+        }
+        next_prev += 1;
+      }
+      const Name_Blob_Entry *entry = &blob->entries.items[index];
+      Name_Blob_Field field = NAME_BLOB_EXE;
+      while (field > NAME_BLOB_NAME && entry->offset[field] > found) field -= 1;
+      int score = search_exact_score_from(search, index, field, found - entry->offset[field], pattern, len);
+      level->hits.items[level->hits.count++] = (Search_Hit) { .index = index, .score = score };
+      if (prev) {
+        at = next_prev < prev->count ? blob->entries.items[prev->items[next_prev].index].offset[NAME_BLOB_NAME] : blob->len;
+      } else {
+        at = index + 1 < blob->entries.count ? blob->entries.items[index + 1].offset[NAME_BLOB_NAME] : blob->len;
+      }
+    }
+    return;
+  }
+
+  Game_Indices *candidates = &search->candidates;
+  candidates->count = 0;
+  if (indexed) {
+    trigram_index_query(trigrams, pattern, len, candidates);
+    if (prev) {
+      size_t kept = 0, j = 0;
+      for (size_t i = 0; i < candidates->count; ++i) {
+        while (j < prev->count && prev->items[j].index < candidates->items[i]) j += 1;
+        if (j == prev->count) break;
+        if (prev->items[j].index == candidates->items[i]) candidates->items[kept++] = candidates->items[i];
+      }
+      candidates->count = kept;
+    }
+  } else if (prev) {
+    for (size_t i = 0; i < prev->count; ++i) nob_da_append(candidates, prev->items[i].index);
+  } else {
+    for (size_t i = 0; i < games->count; ++i) nob_da_append(candidates, i);
+  }
+
+  nob_da_reserve(&level->hits, candidates->count);
+  for (size_t i = 0; i < candidates->count; ++i) {
+    size_t index = candidates->items[i];
+    int score = search_exact_score(search, index, pattern, len);
+    if (score >= 0) level->hits.items[level->hits.count++] = (Search_Hit) { .index = index, .score = score };
+  }
+}
+
+// The first level goes through the whole catalog, so it is split in blocks that each fill their own part of the
+// output and get compacted afterwards. Blocks instead of one part per thread keep the output in catalog order
+#define SEARCH_ROOT_BLOCK 4096
+
+typedef struct {
+  const Search *search;
+  const Games *games;
+  Search_Hit *hits;
+  size_t *block_counts;
+  uint64_t wanted;
+} Search_Root_Ctx;
+
+void search_root_blocks(void *arg, size_t begin, size_t end) {
+  Search_Root_Ctx *ctx = arg;
+  const Search *search = ctx->search;
+  for (size_t b = begin; b < end; ++b) {
+    size_t first = b*SEARCH_ROOT_BLOCK;
+    size_t last = MIN(first + SEARCH_ROOT_BLOCK, ctx->games->count);
+    Search_Hit *out = ctx->hits + first;
+    size_t count = 0;
+    for (size_t i = first; i < last; ++i) {
+      if ((search->masks.items[i] & ctx->wanted) != ctx->wanted) continue;
+      Search_Hit hit = { .index = i, .name = FUZZY_START, .alias = FUZZY_START };
+      if (search_hit_step(&hit, &ctx->games->items[i], search->query.items, search->query.count, search->query.count)) {
+        out[count++] = hit;
+      }
+    }
+    ctx->block_counts[b] = count;
+  }
+}
+
+// Pushes a level for the query as it is now, stepping the hits of the level below it or the whole catalog if there
+// is none by what was added to the query since
+void search_push_level(Search *search, const Games *games) {
+  if (search->depth == search->levels.count) nob_da_append(&search->levels, (Search_Level) {0});
+  Search_Level *level = &search->levels.items[search->depth];
+  level->query_len = search->query.count;
+  level->hits.count = 0;
+
+  if (search_is_filter(search)) {
+    // Left empty
+  } else if (search_is_exact(search)) {
+    search_push_exact(search, games, level);
+  } else if (search->depth == 0) {
+    size_t blocks = (games->count + SEARCH_ROOT_BLOCK - 1)/SEARCH_ROOT_BLOCK;
+    size_t save = nob_temp_save();
+    size_t *block_counts = nob_temp_alloc(sizeof(size_t)*blocks);
+    nob_da_reserve(&level->hits, games->count);
+    Search_Root_Ctx ctx = {
+      .search = search,
+      .games = games,
+      .hits = level->hits.items,
+      .block_counts = block_counts,
+      .wanted = search_chars_mask(search->query.items, search->query.count),
+    };
+    parallel_for(blocks, 2, search_root_blocks, &ctx);
+    for (size_t b = 0; b < blocks; ++b) {
+      memmove(level->hits.items + level->hits.count, level->hits.items + b*SEARCH_ROOT_BLOCK, sizeof(Search_Hit)*block_counts[b]);
+      level->hits.count += block_counts[b];
+    }
+    nob_temp_rewind(save);
+  } else {
+    const Search_Level *prev = &search->levels.items[search->depth - 1];
+    const char *added = search->query.items + prev->query_len;
+    size_t added_len = search->query.count - prev->query_len;
+    uint64_t wanted = search_chars_mask(added, added_len);
+    nob_da_reserve(&level->hits, prev->hits.count);
+    for (size_t i = 0; i < prev->hits.count; ++i) {
+      Search_Hit hit = prev->hits.items[i];
+      if ((search->masks.items[hit.index] & wanted) != wanted) continue;
+      if (search_hit_step(&hit, &games->items[hit.index], added, added_len, search->query.count)) {
+        level->hits.items[level->hits.count++] = hit;
+      }
+    }
+  }
+  search->depth += 1;
+}
+
+void search_append(Search *search, const Games *games, const char *text, size_t len) {
+  nob_sb_append_buf(&search->query, text, len);
+  search_push_level(search, games);
+  search_order(search);
+}
+
+void search_pop(Search *search) {
+  if (search->depth == 0) return;
+  search->depth -= 1;
+  search->query.count = search->depth > 0 ? search->levels.items[search->depth - 1].query_len : 0;
+  search_order(search);
+}
+
+void search_clear(Search *search) {
+  search->depth = 0;
+  search->query.count = 0;
+  search_order(search);
+}
+
+// A different catalog invalidates every level, the query is matched again from scratch one codepoint at a time so
+// backspace keeps working the same
+void search_sync(Search *search, const Games *games) {
+  if (search->catalog_version == games->version && search->masks.count == games->count) return;
+  search->catalog_version = games->version;
+  nob_da_resize(&search->masks, games->count);
+  for (size_t i = 0; i < games->count; ++i) search->masks.items[i] = search_game_mask(&games->items[i]);
+  name_blob_build(&search->blob, games);
+  if (search->depth == 0) return;
+
+  size_t save = nob_temp_save();
+  size_t levels = search->depth;
+  size_t *lens = nob_temp_alloc(sizeof(size_t)*levels);
+  for (size_t i = 0; i < levels; ++i) lens[i] = search->levels.items[i].query_len;
+  size_t query_len = search->query.count;
+  search->depth = 0;
+  for (size_t i = 0; i < levels; ++i) {
+    search->query.count = lens[i];
+    search_push_level(search, games);
+  }
+  search->query.count = query_len;
+  nob_temp_rewind(save);
+  search_order(search);
+}
+
+// Returns true when the query changed
+bool search_update(Search *search, const Games *games) {
+  bool changed = false;
+  for (int codepoint = GetCharPressed(); codepoint > 0; codepoint = GetCharPressed()) {
+    int len = 0;
+    const char *utf8 = CodepointToUTF8(codepoint, &len);
+    search_append(search, games, utf8, len);
+    changed = true;
+  }
+  if (search->depth > 0 && (IsKeyPressed(KEY_BACKSPACE) || IsKeyPressedRepeat(KEY_BACKSPACE))) {
+    if (IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL)) search_clear(search);
+    else search_pop(search);
+    changed = true;
+  }
+  if (search->depth > 0 && IsKeyPressed(KEY_ESCAPE)) {
+    search_clear(search);
+    changed = true;
+  }
+  return changed;
+}
+
+// The query is drawn with the default font since the UI font only has the glyphs of the titles
+void search_draw(const Search *search, Rectangle bar, size_t shown, size_t total) {
+  DrawRectangleRec(bar, RGB(24, 24, 24));
+  DrawRectangleLinesEx(bar, 1, GAME_BUTTON_LINE_COLOR);
+  size_t save = nob_temp_save();
+  const char *query = nob_temp_sv_to_cstr(nob_sb_to_sv(search->query));
+  int y = (int)(bar.y + (bar.height - SEARCH_FONT_SIZE)/2);
+  DrawText(query, (int)bar.x + GENERAL_PADDING, y, SEARCH_FONT_SIZE, GAME_BUTTON_TEXT_COLOR);
+  const char *count = nob_temp_sprintf("%zu / %zu", shown, total);
+  int count_width = MeasureText(count, SEARCH_FONT_SIZE);
+  DrawText(count, (int)(bar.x + bar.width) - GENERAL_PADDING - count_width, y, SEARCH_FONT_SIZE, GAME_BUTTON_LINE_COLOR);
+  nob_temp_rewind(save);
+}
+
+void search_free(Search *search) {
+  for (size_t i = 0; i < search->levels.count; ++i) free(search->levels.items[i].hits.items);
+  free(search->levels.items);
+  free(search->query.items);
+  free(search->order.items);
+  free(search->masks.items);
+  free(search->candidates.items);
+  free(search->pattern.items);
+  name_blob_free(&search->blob);
+  *search = (Search) {0};
+}
+
+
+// What lzua remembers about the games of a directory. It is kept in LIBRARY_FILE inside the games directory as text
+// with a section per game, keyed by the folder and executable of the game since a folder can have several:
+//
+//   [Hollow Knight/hollow_knight.x86_64]
+//   alias = HK
+//   added = 1750000000
+//   launches = 12
+//   last_launch = 1760000000
+//   frecency = 3.25
+//   playtime = 86400
+//   size = 8589934592
+//   size_mtime = 1750000000
+//   tags = metroidvania, coop
+//   meta.rating = 9
+//
+// Sections of games that are not in the directory right now are kept as they are so their history is still there
+// when they come back, and so are the fields this build does not know, for the builds that do. Tags and custom
+// metadata, the fields named META_FIELD_PREFIX and a name of its own, are kept with those as the lines they are.
+//
+// Every save also compiles it to LIBRARY_BINARY_FILE: fixed size records pointing into a string table and the
+// permutation of every sort mode, checked with a CRC32. Starting takes that one as is while it is not older than the
+// text, the text is only parsed again after someone edited it. When the catalog is the one that was saved the orders
+// come straight from it too and nothing gets sorted. Different builds share the directory, so the binary is a run of
+// sections that each say what they are and how long they are. Readers skip the ones they do not know, and the ones
+// whose tag starts in lowercase do not depend on the records and are written back as they came. Records say their
+// own size so a newer build can add fields at their end.
+//
+// Changes in between go to LIBRARY_JOURNAL_FILE instead, a record per stat that changed appended to the end, and
+// loading replays them over the other two. Once the journal grows past LIBRARY_JOURNAL_LIMIT the persister folds it
+// into them and starts it over. Records of kinds this build does not know are skipped
+#define LIBRARY_FILE ".lzua"
+#define LIBRARY_BINARY_FILE ".lzua.bin"
+#define LIBRARY_BINARY_MAGIC 0x42555a4c // "LZUB"
+#define LIBRARY_BINARY_VERSION 2
+#define LIBRARY_SECTION_TAG(a, b, c, d) ((uint32_t)(a) | (uint32_t)(b) << 8 | (uint32_t)(c) << 16 | (uint32_t)(d) << 24)
+#define LIBRARY_SECTION_RECORDS LIBRARY_SECTION_TAG('R', 'E', 'C', 'S')
+#define LIBRARY_SECTION_STRINGS LIBRARY_SECTION_TAG('S', 'T', 'R', 'S')
+#define LIBRARY_SECTION_ORDER   LIBRARY_SECTION_TAG('O', 'R', 'D', 'R')
+#define LIBRARY_SECTION_ORPHANS LIBRARY_SECTION_TAG('O', 'R', 'P', 'H')
+#define LIBRARY_JOURNAL_FILE ".lzua.log"
+#define LIBRARY_JOURNAL_MAGIC 0x4a555a4c // "LZUJ"
+#define LIBRARY_JOURNAL_VERSION 1
+#define LIBRARY_JOURNAL_LIMIT (1 << 20)
+#define META_FIELD_PREFIX "meta."
+#define LIBRARY_NO_STRING UINT32_MAX
+#define FRECENCY_HALF_LIFE (14*24*60*60.0) // Seconds for the weight of a launch to halve
+#define RECENT_STRIP_COUNT 8
+#define SORT_MODE_KEY KEY_TAB
+
+// Saved by value, new modes go at the end
+typedef enum {
+  SORT_MOST_PLAYED,
+  SORT_NAME,
+  SORT_LAST_PLAYED,
+  SORT_PLAYTIME,
+  SORT_SIZE,
+  SORT_DATE_ADDED,
+  SORT_MODE_COUNT,
+} Sort_Mode;
+
+static const char *sort_mode_names[SORT_MODE_COUNT] = {
+  [SORT_MOST_PLAYED] = "most played",
+  [SORT_NAME] = "name",
+  [SORT_LAST_PLAYED] = "last played",
+  [SORT_PLAYTIME] = "playtime",
+  [SORT_SIZE] = "size on disk",
+  [SORT_DATE_ADDED] = "date added",
+};
+
+typedef struct {
+  uint32_t launches;
+  int64_t last_launch;
+  // Score at last_launch, it halves every FRECENCY_HALF_LIFE seconds after that
+  double frecency;
+  // Seconds spent in the game
+  int64_t playtime;
+  // Bytes on disk, 0 while nobody measured it
+  uint64_t size;
+  // Modification time of the folder when size was measured, it is measured again when the folder changes
+  int64_t size_mtime;
+  int64_t added;
+  // Interned lines of the fields this build does not know, NULL when there are none
+  const char *extra;
+} Game_Stats;
+
+typedef struct {
+  uint32_t magic;
+  // Of the build that wrote it, readers go by the sections. A change old readers could not skip needs a new magic
+  uint32_t version;
+  // Bytes of sections after the header
+  uint32_t size;
+  // ComputeCRC32 of those
+  uint32_t crc;
+} Library_File_Header;
+
+// What the first build of the binary had, before it had sections: the records, SORT_MODE_COUNT orders and the strings
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t record_count;
+  uint32_t strings_size;
+  uint32_t orphans;
+  uint32_t crc;
+} Library_File_Header_V1;
+
+typedef struct {
+  uint32_t tag;
+  // Of the payload that follows, which is padded to 8 bytes so the next section starts aligned
+  uint32_t size;
+} Library_File_Section;
+
+// Starts the payload of the records section
+typedef struct {
+  uint32_t record_size;
+  uint32_t count;
+} Library_File_Records;
+
+// Starts the payload of an orders section, there is one per Sort_Mode
+typedef struct {
+  uint32_t mode;
+  uint32_t count;
+} Library_File_Order;
+
+typedef struct {
+  // Offsets into the string table
+  uint32_t key;
+  uint32_t alias;
+  uint32_t launches;
+  uint32_t padding;
+  int64_t last_launch;
+  double frecency;
+  int64_t playtime;
+  uint64_t size;
+  int64_t size_mtime;
+  int64_t added;
+  // Version 2 on
+  uint32_t extra;
+  uint32_t padding2;
+} Library_File_Record;
+
+// Where the parts of a binary are in its mapping, whichever version wrote it
+typedef struct {
+  const unsigned char *records;
+  size_t record_size;
+  size_t record_count;
+  const char *strings;
+  size_t strings_size;
+  const char *orphans;
+  const uint32_t *orders[SORT_MODE_COUNT];
+} Library_File_View;
+
+typedef struct {
+  double key;
+  size_t index;
+} Sort_Entry;
+
+typedef struct {
+  uint64_t prefix;
+  size_t index;
+} Name_Entry;
+
+// Stats and custom metadata laid out by column for filters, see filter_compile. Numbers are doubles with NAN where a
+// game has none, tags are a bitset per tag and text values are ids into a dictionary
+typedef enum {
+  META_SIZE,
+  META_PLAYTIME,
+  META_LAUNCHES,
+  META_LAST_LAUNCH,
+  META_ADDED,
+  META_BUILTIN_COUNT,
+} Meta_Builtin;
+
+// Interned strings and their ids, open addressing by the hash of the string so lookups need not intern
+typedef struct {
+  List(const char *) names;
+  uint32_t *slots;
+  size_t capacity;
+} Meta_Dictionary;
+
+typedef struct {
+  const char *name;
+  List(double) numbers;
+  // Into the values dictionary, 0 where the game has none
+  List(uint32_t) ids;
+} Meta_Column;
+
+typedef struct {
+  size_t count;
+  // Of uint64_t per bitset
+  size_t words;
+  // Tag t has the words [t*words, (t + 1)*words) of tag_bits
+  Meta_Dictionary tags;
+  List(uint64_t) tag_bits;
+  List(double) builtins[META_BUILTIN_COUNT];
+  List(Meta_Column) columns;
+  Meta_Dictionary column_names;
+  Meta_Dictionary values;
+  size_t version;
+} Library_Meta;
+
+typedef struct {
+  const Games *games;
+  // By catalog index, the same goes for keys, titles and name_prefixes
+  List(Game_Stats) stats;
+  List(const char *) keys;
+  // Interned, tells when a title changed without comparing the strings
+  List(const char *) titles;
+  // First 8 case folded bytes of every title, big endian so comparing them compares the start of the titles
+  List(uint64_t) name_prefixes;
+  // Open addressing from section key to catalog index, capacity is a power of two
+  size_t *lookup;
+  size_t lookup_capacity;
+  // The catalog in the order of every sort mode. The catalog itself is never reordered, switching modes only
+  // switches which of these the grid shows
+  Game_Indices orders[SORT_MODE_COUNT];
+  size_t order_versions[SORT_MODE_COUNT];
+  Sort_Mode sort;
+  // The most recently launched games, most recent first
+  Game_Indices recent;
+  Nob_String_Builder orphans;
+  size_t catalog_version;
+  size_t recent_version;
+  // Games whose stats changed since the last time they were handed to the persister
+  Game_Indices changes;
+  // How much of the journal was good when it was loaded
+  size_t journal_size;
+  // Sections of the binary from newer builds that do not depend on the records, written back as they came
+  Nob_String_Builder kept_sections;
+  Library_Meta meta;
+} Library;
+
+uint32_t meta_dictionary_find(const Meta_Dictionary *dict, const char *name) {
+  if (dict->capacity == 0) return UINT32_MAX;
+  size_t mask = dict->capacity - 1;
+  for (size_t i = hash_cstr(name) & mask; dict->slots[i] != UINT32_MAX; i = (i + 1) & mask) {
+    if (streq(dict->names.items[dict->slots[i]], name)) return dict->slots[i];
+  }
+  return UINT32_MAX;
+}
+
+uint32_t meta_dictionary_add(Meta_Dictionary *dict, const char *name) {
+  uint32_t id = meta_dictionary_find(dict, name);
+  if (id != UINT32_MAX) return id;
+  if ((dict->names.count + 1)*2 > dict->capacity) {
+    size_t capacity = dict->capacity ? dict->capacity*2 : 16;
+    free(dict->slots);
+    dict->slots = malloc(sizeof(uint32_t)*capacity);
+    NOB_ASSERT(dict->slots != NULL && "Buy more RAM lol");
+    memset(dict->slots, 0xff, sizeof(uint32_t)*capacity);
+    dict->capacity = capacity;
+    for (uint32_t n = 0; n < dict->names.count; ++n) {
+      size_t j = hash_cstr(dict->names.items[n]) & (capacity - 1);
+      while (dict->slots[j] != UINT32_MAX) j = (j + 1) & (capacity - 1);
+      dict->slots[j] = n;
+    }
+  }
+  id = (uint32_t)dict->names.count;
+  nob_da_append(&dict->names, intern_cstr(&title_interns, name));
+  size_t j = hash_cstr(name) & (dict->capacity - 1);
+  while (dict->slots[j] != UINT32_MAX) j = (j + 1) & (dict->capacity - 1);
+  dict->slots[j] = id;
+  return id;
+}
+
+void meta_dictionary_free(Meta_Dictionary *dict) {
+  free(dict->names.items);
+  free(dict->slots);
+  *dict = (Meta_Dictionary) {0};
+}
+
+void meta_set_builtins(Library_Meta *meta, size_t index, const Game_Stats *stats) {
+  meta->builtins[META_SIZE].items[index] = stats->size > 0 ? (double)stats->size : NAN;
+  meta->builtins[META_PLAYTIME].items[index] = (double)stats->playtime;
+  meta->builtins[META_LAUNCHES].items[index] = (double)stats->launches;
+  meta->builtins[META_LAST_LAUNCH].items[index] = stats->launches > 0 ? (double)stats->last_launch : NAN;
+  meta->builtins[META_ADDED].items[index] = stats->added != 0 ? (double)stats->added : NAN;
+}
+
+// Case folded copy of the trimmed text in the temp arena
+const char *meta_fold_temp(Nob_String_View sv) {
+  sv = nob_sv_trim(sv);
+  char *folded = nob_temp_alloc(sv.count + 1);
+  for (size_t i = 0; i < sv.count; ++i) folded[i] = fold_ascii(sv.data[i]);
+  folded[sv.count] = '\0';
+  return folded;
+}
+
+// Takes the tags and the meta. fields out of the lines the stats keep for them
+void meta_parse_extra(Library_Meta *meta, size_t index, const char *extra) {
+  Nob_String_View sv = nob_sv_from_cstr(extra);
+  while (sv.count > 0) {
+    Nob_String_View line = nob_sv_chop_by_delim(&sv, '\n');
+    Nob_String_View name = nob_sv_trim(nob_sv_chop_by_delim(&line, '='));
+    size_t save = nob_temp_save();
+    if (nob_sv_eq(name, nob_sv_from_cstr("tags"))) {
+      while (line.count > 0) {
+        const char *tag = meta_fold_temp(nob_sv_chop_by_delim(&line, ','));
+        if (tag[0] == '\0') continue;
+        uint32_t id = meta_dictionary_add(&meta->tags, tag);
+        while (meta->tag_bits.count < (size_t)(id + 1)*meta->words) nob_da_append(&meta->tag_bits, 0);
+        meta->tag_bits.items[id*meta->words + index/64] |= 1ULL << (index%64);
+      }
+    } else if (nob_sv_starts_with(name, nob_sv_from_cstr(META_FIELD_PREFIX))) {
+      nob_sv_chop_left(&name, strlen(META_FIELD_PREFIX));
+      uint32_t id = meta_dictionary_add(&meta->column_names, meta_fold_temp(name));
+      if (id == meta->columns.count) {
+        Meta_Column column = { .name = meta->column_names.names.items[id] };
+        nob_da_resize(&column.numbers, meta->count);
+        nob_da_resize(&column.ids, meta->count);
+        for (size_t i = 0; i < meta->count; ++i) column.numbers.items[i] = NAN;
+        memset(column.ids.items, 0, sizeof(uint32_t)*meta->count);
+        nob_da_append(&meta->columns, column);
+      }
+      Meta_Column *column = &meta->columns.items[id];
+      const char *value = meta_fold_temp(line);
+      char *end = NULL;
+      double number = strtod(value, &end);
+      if (value[0] != '\0' && *end == '\0') column->numbers.items[index] = number;
+      column->ids.items[index] = meta_dictionary_add(&meta->values, value);
+    }
+    nob_temp_rewind(save);
+  }
+}
+
+// Every column again from the stats, after the catalog changed
+void library_meta_build(Library_Meta *meta, const Library *lib) {
+  meta->count = lib->stats.count;
+  meta->words = (meta->count + 63)/64;
+  for (size_t i = 0; i < meta->columns.count; ++i) {
+    free(meta->columns.items[i].numbers.items);
+    free(meta->columns.items[i].ids.items);
+  }
+  meta->columns.count = 0;
+  meta->tag_bits.count = 0;
+  meta_dictionary_free(&meta->tags);
+  meta_dictionary_free(&meta->column_names);
+  meta_dictionary_free(&meta->values);
+  // Id 0 is no value
+  meta_dictionary_add(&meta->values, "");
+  for (int b = 0; b < META_BUILTIN_COUNT; ++b) nob_da_resize(&meta->builtins[b], meta->count);
+  for (size_t i = 0; i < meta->count; ++i) {
+    const Game_Stats *stats = &lib->stats.items[i];
+    meta_set_builtins(meta, i, stats);
+    if (stats->extra) meta_parse_extra(meta, i, stats->extra);
+  }
+  meta->version = game_view_next_version();
+}
+
+void library_meta_free(Library_Meta *meta) {
+  for (size_t i = 0; i < meta->columns.count; ++i) {
+    free(meta->columns.items[i].numbers.items);
+    free(meta->columns.items[i].ids.items);
+  }
+  free(meta->columns.items);
+  free(meta->tag_bits.items);
+  for (int b = 0; b < META_BUILTIN_COUNT; ++b) free(meta->builtins[b].items);
+  meta_dictionary_free(&meta->tags);
+  meta_dictionary_free(&meta->column_names);
+  meta_dictionary_free(&meta->values);
+  *meta = (Library_Meta) {0};
+}
+
+// Has to come after the stats changed
+void library_changed(Library *lib, size_t index) {
+  nob_da_append(&lib->changes, index);
+  if (index < lib->meta.count) {
+    meta_set_builtins(&lib->meta, index, &lib->stats.items[index]);
+    lib->meta.version = game_view_next_version();
+  }
+}
+
+// Decaying every score to now would change them all the time, but since they all decay at the same rate comparing
+// log2(frecency) + last_launch/half life compares them at any instant. A launch only moves the game launched
+double frecency_key(const Game_Stats *stats) {
+  if (stats->launches == 0 || stats->frecency <= 0) return -INFINITY;
+  return log2(stats->frecency) + (double)stats->last_launch/FRECENCY_HALF_LIFE;
+}
+
+double frecency_at(const Game_Stats *stats, int64_t now) {
+  if (stats->launches == 0) return 0;
+  return stats->frecency*exp2(-(double)(now - stats->last_launch)/FRECENCY_HALF_LIFE);
+}
+
+// Every mode but name puts the highest key first
+double sort_key(const Game_Stats *stats, Sort_Mode mode) {
+  switch (mode) {
+    case SORT_MOST_PLAYED: return frecency_key(stats);
+    case SORT_LAST_PLAYED: return stats->launches > 0 ? (double)stats->last_launch : -INFINITY;
+    case SORT_PLAYTIME:    return (double)stats->playtime;
+    case SORT_SIZE:        return (double)stats->size;
+    case SORT_DATE_ADDED:  return (double)stats->added;
+    case SORT_NAME:
+    case SORT_MODE_COUNT:
+    default:               NOB_UNREACHABLE("sort_key");
+  }
+}
+
+uint64_t name_prefix(const char *title, size_t offset) {
+  uint64_t prefix = 0;
+  bool ended = false;
+  for (size_t i = 0; i < 8; ++i) {
+    if (!ended && title[offset + i] == '\0') ended = true;
+    prefix = prefix << 8 | (ended ? 0 : (unsigned char)fold_ascii(title[offset + i]));
+  }
+  return prefix;
+}
+
+// Case insensitive, catalog order between equal titles
+int name_compare(const Library *lib, size_t a, size_t b) {
+  uint64_t pa = lib->name_prefixes.items[a], pb = lib->name_prefixes.items[b];
+  if (pa != pb) return pa < pb ? -1 : 1;
+  // A prefix that does not end in 0 means the title goes on past it
+  if ((pa & 0xff) != 0) {
+    const char *ta = lib->titles.items[a] + 8, *tb = lib->titles.items[b] + 8;
+    for (;; ++ta, ++tb) {
+      unsigned char ca = (unsigned char)fold_ascii(*ta), cb = (unsigned char)fold_ascii(*tb);
+      if (ca != cb) return ca < cb ? -1 : 1;
+      if (ca == 0) break;
+    }
+  }
+  return (a > b) - (a < b);
+}
+
+bool order_before(const Library *lib, Sort_Mode mode, size_t a, size_t b) {
+  if (mode == SORT_NAME) return name_compare(lib, a, b) < 0;
+  double ka = sort_key(&lib->stats.items[a], mode), kb = sort_key(&lib->stats.items[b], mode);
+  if (ka != kb) return ka > kb;
+  return a < b;
+}
+
+size_t order_position(const Library *lib, Sort_Mode mode, size_t index) {
+  const Game_Indices *order = &lib->orders[mode];
+  size_t lo = 0, hi = order->count;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo)/2;
+    if (order_before(lib, mode, order->items[mid], index)) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+// Has to happen while the stats still sort the game where it is
+size_t order_remove(Library *lib, Sort_Mode mode, size_t index) {
+  Game_Indices *order = &lib->orders[mode];
+  size_t at = order_position(lib, mode, index);
+  NOB_ASSERT(at < order->count && order->items[at] == index);
+  memmove(order->items + at, order->items + at + 1, sizeof(size_t)*(order->count - at - 1));
+  order->count -= 1;
+  return at;
+}
+
+size_t order_insert(Library *lib, Sort_Mode mode, size_t index) {
+  Game_Indices *order = &lib->orders[mode];
+  size_t at = order_position(lib, mode, index);
+  nob_da_append(order, 0);
+  memmove(order->items + at + 1, order->items + at, sizeof(size_t)*(order->count - at - 1));
+  order->items[at] = index;
+  return at;
+}
+
+// Changing what a game sorts by goes between these two, the game is taken out of every order before and put back
+// where it belongs after. Nothing else moves
+void library_reorder_begin(Library *lib, size_t index, size_t positions[SORT_MODE_COUNT]) {
+  for (int mode = 0; mode < SORT_MODE_COUNT; ++mode) positions[mode] = order_remove(lib, mode, index);
+}
+
+void library_reorder_end(Library *lib, size_t index, const size_t positions[SORT_MODE_COUNT]) {
+  for (int mode = 0; mode < SORT_MODE_COUNT; ++mode) {
+    if (order_insert(lib, mode, index) != positions[mode]) lib->order_versions[mode] = game_view_next_version();
+  }
+}
+
+int compare_sort_entries(const void *a, const void *b) {
+  const Sort_Entry *x = a, *y = b;
+  if (x->key != y->key) return x->key > y->key ? -1 : 1;
+  return (x->index > y->index) - (x->index < y->index);
+}
+
+// LSD radix sort over the bytes of the prefixes, skipping the bytes every prefix shares. It is stable so equal
+// prefixes keep the order they came in
+void name_radix_sort(Name_Entry *entries, Name_Entry *scratch, size_t count) {
+  for (int shift = 0; shift < 64; shift += 8) {
+    size_t offsets[256] = {0};
+    for (size_t i = 0; i < count; ++i) offsets[(entries[i].prefix >> shift) & 0xff] += 1;
+    if (offsets[(entries[0].prefix >> shift) & 0xff] == count) continue;
+    size_t sum = 0;
+    for (size_t b = 0; b < 256; ++b) {
+      size_t n = offsets[b];
+      offsets[b] = sum;
+      sum += n;
+    }
+    for (size_t i = 0; i < count; ++i) scratch[offsets[(entries[i].prefix >> shift) & 0xff]++] = entries[i];
+    memcpy(entries, scratch, sizeof(*entries)*count);
+  }
+}
+
+// Titles that share the whole prefix get sorted again by their next 8 bytes until they differ or end
+void name_sort(const Library *lib, Name_Entry *entries, Name_Entry *scratch, size_t count, size_t offset) {
+  if (count < 2) return;
+  name_radix_sort(entries, scratch, count);
+  for (size_t start = 0; start < count;) {
+    size_t end = start + 1;
+    while (end < count && entries[end].prefix == entries[start].prefix) end += 1;
+    if (end - start > 1 && (entries[start].prefix & 0xff) != 0) {
+      for (size_t i = start; i < end; ++i) {
+        entries[i].prefix = name_prefix(lib->titles.items[entries[i].index], offset + 8);
+      }
+      name_sort(lib, entries + start, scratch, end - start, offset + 8);
+    }
+    start = end;
+  }
+}
+
+void library_build_order(Library *lib, Sort_Mode mode) {
+  size_t count = lib->stats.count;
+  Game_Indices *order = &lib->orders[mode];
+  nob_da_resize(order, count);
+  if (mode == SORT_NAME) {
+    Name_Entry *entries = malloc(sizeof(*entries)*count*2);
+    NOB_ASSERT(entries != NULL && "Buy more RAM lol");
+    for (size_t i = 0; i < count; ++i) entries[i] = (Name_Entry) { .prefix = lib->name_prefixes.items[i], .index = i };
+    name_sort(lib, entries, entries + count, count, 0);
+    for (size_t i = 0; i < count; ++i) order->items[i] = entries[i].index;
+    free(entries);
+  } else {
+    Sort_Entry *entries = malloc(sizeof(*entries)*count);
+    NOB_ASSERT(entries != NULL && "Buy more RAM lol");
+    for (size_t i = 0; i < count; ++i) entries[i] = (Sort_Entry) { .key = sort_key(&lib->stats.items[i], mode), .index = i };
+    qsort(entries, count, sizeof(*entries), compare_sort_entries);
+    for (size_t i = 0; i < count; ++i) order->items[i] = entries[i].index;
+    free(entries);
+  }
+  lib->order_versions[mode] = game_view_next_version();
+}
+
+bool recent_before(const Library *lib, size_t a, size_t b) {
+  int64_t ta = lib->stats.items[a].last_launch, tb = lib->stats.items[b].last_launch;
+  if (ta != tb) return ta > tb;
+  return a < b;
+}
+
+// Min heap on recency, the root is the least recent of the ones kept so far
+void recent_heap_sift_down(const Library *lib, size_t *heap, size_t count, size_t i) {
+  for (;;) {
+    size_t smallest = i, l = 2*i + 1, r = 2*i + 2;
+    if (l < count && recent_before(lib, heap[smallest], heap[l])) smallest = l;
+    if (r < count && recent_before(lib, heap[smallest], heap[r])) smallest = r;
+    if (smallest == i) return;
+    size_t tmp = heap[i];
+    heap[i] = heap[smallest];
+    heap[smallest] = tmp;
+    i = smallest;
+  }
+}
+
+// Keeps the RECENT_STRIP_COUNT most recent launches in a heap of that size, cheaper than sorting the whole catalog
+// for a handful of games
+void library_build_recent(Library *lib) {
+  size_t heap[RECENT_STRIP_COUNT];
+  size_t count = 0;
+  for (size_t i = 0; i < lib->stats.count; ++i) {
+    if (lib->stats.items[i].launches == 0) continue;
+    if (count < RECENT_STRIP_COUNT) {
+      heap[count++] = i;
+      if (count == RECENT_STRIP_COUNT) {
+        for (size_t j = count/2; j-- > 0;) recent_heap_sift_down(lib, heap, count, j);
+      }
+    } else if (recent_before(lib, i, heap[0])) {
+      heap[0] = i;
+      recent_heap_sift_down(lib, heap, count, 0);
+    }
+  }
+  if (count < RECENT_STRIP_COUNT) {
+    for (size_t j = count/2; j-- > 0;) recent_heap_sift_down(lib, heap, count, j);
+  }
+
+  // Popping the heap gives them least recent first
+  nob_da_resize(&lib->recent, count);
+  for (size_t n = count; n > 0; --n) {
+    lib->recent.items[n - 1] = heap[0];
+    heap[0] = heap[n - 1];
+    recent_heap_sift_down(lib, heap, n - 1, 0);
+  }
+  lib->recent_version = game_view_next_version();
+}
+
+size_t library_find(const Library *lib, const char *key) {
+  if (lib->lookup_capacity == 0) return SIZE_MAX;
+  size_t mask = lib->lookup_capacity - 1;
+  for (size_t i = hash_cstr(key) & mask; lib->lookup[i] != SIZE_MAX; i = (i + 1) & mask) {
+    if (streq(lib->keys.items[lib->lookup[i]], key)) return lib->lookup[i];
+  }
+  return SIZE_MAX;
+}
+
+// Copies the folder into sb without its trailing separator. The disk walker threads call it too, so it stays away
+// from the temp arena
+void folder_path_trimmed(Nob_String_Builder *sb, const char *folder) {
+  size_t len = strlen(folder);
+  if (len > 1 && folder[len - 1] == PATH_DELIM) len -= 1;
+  nob_sb_append_buf(sb, folder, len);
+  nob_sb_append_null(sb);
+}
+
+// When a game showed up for the first time, as far as anyone can tell
+int64_t folder_mtime(const char *folder) {
+  Nob_String_Builder path = {0};
+  folder_path_trimmed(&path, folder);
+  struct stat st = {0};
+  int64_t result = stat(path.items, &st) == 0 ? (int64_t)st.st_mtime : (int64_t)time(NULL);
+  free(path.items);
+  return result;
+}
+
+void library_append_fields(Nob_String_Builder *sb, const char *alias, const Game_Stats *stats) {
+  if (alias) nob_sb_appendf(sb, "alias = %s\n", alias);
+  nob_sb_appendf(sb, "added = %lld\n", (long long)stats->added);
+  if (stats->launches > 0) {
+    // Enough digits for the score to read back exactly, otherwise the order could shuffle on the next start
+    nob_sb_appendf(sb, "launches = %u\nlast_launch = %lld\nfrecency = %.17g\n",
+                   stats->launches, (long long)stats->last_launch, stats->frecency);
+  }
+  if (stats->playtime > 0) nob_sb_appendf(sb, "playtime = %lld\n", (long long)stats->playtime);
+  if (stats->size > 0) {
+    nob_sb_appendf(sb, "size = %llu\nsize_mtime = %lld\n", (unsigned long long)stats->size, (long long)stats->size_mtime);
+  }
+  if (stats->extra) nob_sb_append_cstr(sb, stats->extra);
+}
+
+void library_append_section(Nob_String_Builder *sb, const char *key, const char *alias, const Game_Stats *stats) {
+  nob_sb_appendf(sb, "\n[%s]\n", key);
+  library_append_fields(sb, alias, stats);
+}
+
+// What comes before the = of a field line
+Nob_String_View library_field_name(Nob_String_View line) {
+  return nob_sv_trim(nob_sv_chop_by_delim(&line, '='));
+}
+
+bool library_fields_have(Nob_String_View fields, Nob_String_View name) {
+  while (fields.count > 0) {
+    if (nob_sv_eq(library_field_name(nob_sv_chop_by_delim(&fields, '\n')), name)) return true;
+  }
+  return false;
+}
+
+// Where the section of key is in the orphans, from the newline before its header up to the one before the next
+// header. False when there is none
+bool library_orphan_find(const Nob_String_Builder *orphans, Nob_String_View key, size_t *begin, size_t *end) {
+  const char *text = orphans->items;
+  for (size_t i = 0; i + key.count + 4 <= orphans->count; ++i) {
+    if (text[i] != '\n' || text[i + 1] != '[' || text[i + 2 + key.count] != ']') continue;
+    if (text[i + 3 + key.count] != '\n' || memcmp(text + i + 2, key.data, key.count) != 0) continue;
+    size_t j = i + 3 + key.count;
+    while (j + 1 < orphans->count && !(text[j] == '\n' && text[j + 1] == '[')) j += 1;
+    *begin = i;
+    *end = j + 1 < orphans->count ? j : orphans->count;
+    return true;
+  }
+  return false;
+}
+
+// Orphans keep one section per key. The fields given replace the ones of the same name in the section the key
+// already has, a key without one gets a new section
+void library_orphan_update(Nob_String_Builder *orphans, Nob_String_View key, Nob_String_View fields) {
+  size_t begin = 0, end = 0;
+  if (!library_orphan_find(orphans, key, &begin, &end)) {
+    nob_sb_appendf(orphans, "\n["SV_Fmt"]\n", SV_Arg(key));
+    nob_sb_append_buf(orphans, fields.data, fields.count);
+    return;
+  }
+
+  Nob_String_Builder section = {0};
+  size_t header = key.count + 4;
+  nob_sb_append_buf(&section, orphans->items + begin, header);
+  Nob_String_View old = nob_sv_from_parts(orphans->items + begin + header, end - begin - header);
+  while (old.count > 0) {
+    Nob_String_View line = nob_sv_chop_by_delim(&old, '\n');
+    if (line.count == 0 || library_fields_have(fields, library_field_name(line))) continue;
+    nob_sb_append_buf(&section, line.data, line.count);
+    nob_da_append(&section, '\n');
+  }
+  nob_sb_append_buf(&section, fields.data, fields.count);
+
+  size_t tail = orphans->count - end;
+  size_t count = begin + section.count + tail;
+  nob_da_reserve(orphans, count);
+  memmove(orphans->items + begin + section.count, orphans->items + end, tail);
+  memcpy(orphans->items + begin, section.items, section.count);
+  orphans->count = count;
+  free(section.items);
+}
+
+void library_orphan_put(Nob_String_Builder *orphans, const char *key, const char *alias, const Game_Stats *stats) {
+  Nob_String_Builder fields = {0};
+  library_append_fields(&fields, alias, stats);
+  library_orphan_update(orphans, nob_sv_from_cstr(key), nob_sb_to_sv(fields));
+  free(fields.items);
+}
+
+// Follows the catalog by key. Returns for every game it knew where that game is now, SIZE_MAX for the ones that are
+// gone and their history goes to the orphans. Games it did not know start with empty stats
+size_t *library_index_catalog(Library *lib, const Games *games) {
+  lib->games = games;
+  lib->catalog_version = games->version;
+  size_t old_count = lib->stats.count;
+
+  const char **old_keys = lib->keys.items;
+  lib->keys.items = NULL;
+  lib->keys.count = lib->keys.capacity = 0;
+  nob_da_resize(&lib->keys, games->count);
+  nob_da_resize(&lib->titles, games->count);
+  nob_da_resize(&lib->name_prefixes, games->count);
+  free(lib->lookup);
+  lib->lookup_capacity = 16;
+  while (lib->lookup_capacity < games->count*2) lib->lookup_capacity *= 2;
+  lib->lookup = malloc(sizeof(size_t)*lib->lookup_capacity);
+  NOB_ASSERT(lib->lookup != NULL && "Buy more RAM lol");
+  memset(lib->lookup, 0xff, sizeof(size_t)*lib->lookup_capacity);
+  for (size_t i = 0; i < games->count; ++i) {
+    const Game *game = &games->items[i];
+    size_t save = nob_temp_save();
+    lib->keys.items[i] = intern_cstr(&title_interns, nob_temp_sprintf("%s/%s", game->name, game->exe));
+    nob_temp_rewind(save);
+    size_t j = hash_cstr(lib->keys.items[i]) & (lib->lookup_capacity - 1);
+    while (lib->lookup[j] != SIZE_MAX) j = (j + 1) & (lib->lookup_capacity - 1);
+    lib->lookup[j] = i;
+  }
+
+  Game_Stats *stats = calloc(games->count, sizeof(*stats));
+  size_t *moved_to = malloc(sizeof(size_t)*(old_count + 1));
+  NOB_ASSERT(stats != NULL && moved_to != NULL && "Buy more RAM lol");
+  for (size_t i = 0; i < old_count; ++i) {
+    moved_to[i] = library_find(lib, old_keys[i]);
+    if (moved_to[i] != SIZE_MAX) {
+      stats[moved_to[i]] = lib->stats.items[i];
+    } else {
+      library_orphan_put(&lib->orphans, old_keys[i], NULL, &lib->stats.items[i]);
+    }
+  }
+  free(old_keys);
+  free(lib->stats.items);
+  lib->stats.items = stats;
+  lib->stats.count = games->count;
+  lib->stats.capacity = games->count;
+  return moved_to;
+}
+
+// Returns true when the game was new
+bool library_stamp_new(Library *lib, size_t index) {
+  Game_Stats *stats = &lib->stats.items[index];
+  if (stats->added != 0) return false;
+  stats->added = folder_mtime(lib->games->items[index].folder);
+  library_changed(lib, index);
+  return true;
+}
+
+void library_build_orders(Library *lib) {
+  for (size_t i = 0; i < lib->stats.count; ++i) {
+    lib->titles.items[i] = game_title(&lib->games->items[i]);
+    lib->name_prefixes.items[i] = name_prefix(lib->titles.items[i], 0);
+  }
+  for (int mode = 0; mode < SORT_MODE_COUNT; ++mode) library_build_order(lib, mode);
+  library_build_recent(lib);
+}
+
+// Orders saved by another build may sort by rules that are not the ones of order_before, a different fold or tie
+// break, and the binary searches that keep the orders up to date would miss in them. One pass over each tells
+bool library_orders_sorted(const Library *lib) {
+  for (int mode = 0; mode < SORT_MODE_COUNT; ++mode) {
+    const Game_Indices *order = &lib->orders[mode];
+    for (size_t i = 1; i < order->count; ++i) {
+      if (!order_before(lib, mode, order->items[i - 1], order->items[i])) return false;
+    }
+  }
+  return true;
+}
+
+// Keeps the orders in step with the catalog. Games that are gone are dropped from them and new ones are inserted,
+// only a catalog that changed a lot gets sorted again
+void library_sync(Library *lib, const Games *games) {
+  if (lib->games == games && lib->catalog_version == games->version && lib->stats.count == games->count) return;
+  size_t old_count = lib->stats.count;
+  const char **old_titles = malloc(sizeof(char*)*(old_count + 1));
+  NOB_ASSERT(old_titles != NULL && "Buy more RAM lol");
+  if (old_count > 0) memcpy(old_titles, lib->titles.items, sizeof(char*)*old_count);
+  size_t *moved_to = library_index_catalog(lib, games);
+
+  bool *known = calloc(games->count + 1, sizeof(bool));
+  NOB_ASSERT(known != NULL && "Buy more RAM lol");
+  bool renamed = false;
+  for (size_t i = 0; i < old_count; ++i) {
+    if (moved_to[i] == SIZE_MAX) continue;
+    known[moved_to[i]] = true;
+    renamed |= game_title(&games->items[moved_to[i]]) != old_titles[i];
+  }
+  size_t added = 0;
+  for (size_t i = 0; i < games->count; ++i) {
+    if (known[i]) continue;
+    added += 1;
+    library_stamp_new(lib, i);
+  }
+
+  if (old_count == 0 || added*8 > games->count) {
+    library_build_orders(lib);
+  } else {
+    for (size_t i = 0; i < games->count; ++i) {
+      lib->titles.items[i] = game_title(&games->items[i]);
+      lib->name_prefixes.items[i] = name_prefix(lib->titles.items[i], 0);
+    }
+    // The games that stayed keep their relative order, so the orders only need their indices renamed
+    for (int mode = 0; mode < SORT_MODE_COUNT; ++mode) {
+      Game_Indices *order = &lib->orders[mode];
+      size_t kept = 0;
+      for (size_t k = 0; k < order->count; ++k) {
+        size_t to = moved_to[order->items[k]];
+        if (to != SIZE_MAX) order->items[kept++] = to;
+      }
+      order->count = kept;
+      for (size_t i = 0; i < games->count; ++i) {
+        if (!known[i]) order_insert(lib, mode, i);
+      }
+      lib->order_versions[mode] = game_view_next_version();
+    }
+    if (renamed) library_build_order(lib, SORT_NAME);
+    library_build_recent(lib);
+  }
+  library_meta_build(&lib->meta, lib);
+
+  free(known);
+  free(moved_to);
+  free(old_titles);
+}
+
+Game_View library_view(const Library *lib) {
+  const Game_Indices *order = &lib->orders[lib->sort];
+  return (Game_View) { .items = order->items, .count = order->count, .version = lib->order_versions[lib->sort] };
+}
+
+Game_View library_recent_view(const Library *lib) {
+  return (Game_View) { .items = lib->recent.items, .count = lib->recent.count, .version = lib->recent_version };
+}
+
+// Switching only picks another permutation, the layout redoes itself because the view version changes
+void library_set_sort(Library *lib, Sort_Mode mode) {
+  lib->sort = mode;
+  nob_log(NOB_INFO, "Sorting by %s", sort_mode_names[mode]);
+}
+
+// Tab goes to the next sort mode and Shift+Tab to the previous one. Returns true when the mode changed
+bool library_update(Library *lib) {
+  if (!IsKeyPressed(SORT_MODE_KEY)) return false;
+  bool back = IsKeyDown(KEY_LEFT_SHIFT) || IsKeyDown(KEY_RIGHT_SHIFT);
+  library_set_sort(lib, (lib->sort + (back ? SORT_MODE_COUNT - 1 : 1)) % SORT_MODE_COUNT);
+  return true;
+}
+
+void library_record_launch(Library *lib, size_t index, int64_t now) {
+  size_t positions[SORT_MODE_COUNT];
+  library_reorder_begin(lib, index, positions);
+  Game_Stats *stats = &lib->stats.items[index];
+  stats->frecency = frecency_at(stats, now) + 1.0;
+  stats->last_launch = now;
+  stats->launches += 1;
+  library_reorder_end(lib, index, positions);
+
+  size_t kept = 0;
+  for (size_t i = 0; i < lib->recent.count; ++i) {
+    if (lib->recent.items[i] != index) lib->recent.items[kept++] = lib->recent.items[i];
+  }
+  lib->recent.count = MIN(kept, RECENT_STRIP_COUNT - 1);
+  nob_da_append(&lib->recent, 0);
+  memmove(lib->recent.items + 1, lib->recent.items, sizeof(size_t)*(lib->recent.count - 1));
+  lib->recent.items[0] = index;
+  lib->recent_version = game_view_next_version();
+
+  library_changed(lib, index);
+}
+
+void library_record_playtime(Library *lib, size_t index, int64_t seconds) {
+  if (index >= lib->stats.count || seconds <= 0) return;
+  size_t positions[SORT_MODE_COUNT];
+  library_reorder_begin(lib, index, positions);
+  lib->stats.items[index].playtime += seconds;
+  library_reorder_end(lib, index, positions);
+  library_changed(lib, index);
+}
+
+void library_set_size(Library *lib, size_t index, uint64_t size, int64_t mtime) {
+  if (index >= lib->stats.count) return;
+  lib->stats.items[index].size_mtime = mtime;
+  if (lib->stats.items[index].size != size) {
+    size_t positions[SORT_MODE_COUNT];
+    library_reorder_begin(lib, index, positions);
+    lib->stats.items[index].size = size;
+    library_reorder_end(lib, index, positions);
+  }
+  library_changed(lib, index);
+}
+
+// Reads the sections of the games in the catalog into it. A missing file is just a directory never launched from
+bool library_parse_text(Library *lib, const char *path, Games *games, bool *aliased) {
+  Nob_String_Builder content = {0};
+  bool read = true;
+  if (nob_file_exists(path) == 1) read = nob_read_entire_file(path, &content);
+
+  size_t current = SIZE_MAX;
+  // A file written before orphans were merged can have a key more than once, its sections merge here
+  bool orphan = false;
+  Nob_String_View orphan_key = {0};
+  Nob_String_Builder orphan_fields = {0};
+  Nob_String_View sv = nob_sb_to_sv(content);
+  while (sv.count > 0) {
+    Nob_String_View raw = nob_sv_chop_by_delim(&sv, '\n');
+    Nob_String_View line = nob_sv_trim(raw);
+    if (line.count == 0 || line.data[0] == '#') continue;
+
+    if (line.data[0] == '[' && line.data[line.count - 1] == ']') {
+      size_t save = nob_temp_save();
+      const char *key = nob_temp_sv_to_cstr(nob_sv_from_parts(line.data + 1, line.count - 2));
+      current = library_find(lib, key);
+      nob_temp_rewind(save);
+      if (orphan) library_orphan_update(&lib->orphans, orphan_key, nob_sb_to_sv(orphan_fields));
+      orphan = current == SIZE_MAX;
+      orphan_key = nob_sv_from_parts(line.data + 1, line.count - 2);
+      orphan_fields.count = 0;
+      continue;
+    }
+
+    if (orphan) {
+      nob_sb_append_buf(&orphan_fields, line.data, line.count);
+      nob_da_append(&orphan_fields, '\n');
+      continue;
+    }
+    if (current == SIZE_MAX) {
+      nob_log(NOB_WARNING, "%s: ignoring line outside of any section: "SV_Fmt, path, SV_Arg(line));
+      continue;
+    }
+
+    Nob_String_View field = line;
+    Nob_String_View name = nob_sv_trim(nob_sv_chop_by_delim(&line, '='));
+    Nob_String_View value = nob_sv_trim(line);
+    size_t save = nob_temp_save();
+    const char *cvalue = nob_temp_sv_to_cstr(value);
+    Game_Stats *stats = &lib->stats.items[current];
+    if (nob_sv_eq(name, nob_sv_from_cstr("alias"))) {
+      games->items[current].alias = value.count > 0 ? intern_cstr(&title_interns, cvalue) : NULL;
+      *aliased = true;
+    } else if (nob_sv_eq(name, nob_sv_from_cstr("added"))) {
+      stats->added = strtoll(cvalue, NULL, 10);
+    } else if (nob_sv_eq(name, nob_sv_from_cstr("launches"))) {
+      stats->launches = (uint32_t)strtoul(cvalue, NULL, 10);
+    } else if (nob_sv_eq(name, nob_sv_from_cstr("last_launch"))) {
+      stats->last_launch = strtoll(cvalue, NULL, 10);
+    } else if (nob_sv_eq(name, nob_sv_from_cstr("frecency"))) {
+      stats->frecency = strtod(cvalue, NULL);
+    } else if (nob_sv_eq(name, nob_sv_from_cstr("playtime"))) {
+      stats->playtime = strtoll(cvalue, NULL, 10);
+    } else if (nob_sv_eq(name, nob_sv_from_cstr("size"))) {
+      stats->size = strtoull(cvalue, NULL, 10);
+    } else if (nob_sv_eq(name, nob_sv_from_cstr("size_mtime"))) {
+      stats->size_mtime = strtoll(cvalue, NULL, 10);
+    } else {
+      // Another build wrote it, it is written back for that one
+      const char *extra = nob_temp_sprintf("%s"SV_Fmt"\n", stats->extra ? stats->extra : "", SV_Arg(field));
+      stats->extra = intern_cstr(&title_interns, extra);
+    }
+    nob_temp_rewind(save);
+  }
+  if (orphan) library_orphan_update(&lib->orphans, orphan_key, nob_sb_to_sv(orphan_fields));
+  free(orphan_fields.items);
+  free(content.items);
+  return read;
+}
+
+#define LIBRARY_SECTION_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+// The first build of the binary, its parts are at fixed places after the header
+bool library_view_v1(const Mapped_File *mf, Library_File_View *view) {
+  Library_File_Header_V1 header = {0};
+  if (mf->size < sizeof(header)) return false;
+  memcpy(&header, mf->data, sizeof(header));
+  size_t records_size = sizeof(Library_File_Record) - 2*sizeof(uint32_t);
+  size_t orders_size = sizeof(uint32_t)*header.record_count*SORT_MODE_COUNT;
+  size_t body_size = records_size*header.record_count + orders_size + header.strings_size;
+  if (mf->size - sizeof(header) != body_size) return false;
+  const unsigned char *body = (const unsigned char *)mf->data + sizeof(header);
+  if (ComputeCRC32((unsigned char *)body, (int)body_size) != header.crc) return false;
+
+  view->records = body;
+  view->record_size = records_size;
+  view->record_count = header.record_count;
+  view->strings = (const char *)body + records_size*header.record_count + orders_size;
+  view->strings_size = header.strings_size;
+  if (header.orphans >= header.strings_size) return false;
+  view->orphans = view->strings + header.orphans;
+  for (int mode = 0; mode < SORT_MODE_COUNT; ++mode) {
+    view->orders[mode] = (const uint32_t *)(body + records_size*header.record_count) + (size_t)mode*header.record_count;
+  }
+  return true;
+}
+
+// Sections it does not know go to kept when they can be written back as they are
+bool library_view_sections(const Mapped_File *mf, Library_File_View *view, Nob_String_Builder *kept) {
+  Library_File_Header header = {0};
+  if (mf->size < sizeof(header)) return false;
+  memcpy(&header, mf->data, sizeof(header));
+  if (mf->size - sizeof(header) != header.size) return false;
+  const unsigned char *data = mf->data;
+  if (ComputeCRC32((unsigned char *)data + sizeof(header), (int)header.size) != header.crc) return false;
+
+  bool has_records = false;
+  size_t order_counts[SORT_MODE_COUNT] = {0};
+  for (size_t at = sizeof(header); at < mf->size;) {
+    Library_File_Section section = {0};
+    if (mf->size - at < sizeof(section)) return false;
+    memcpy(&section, data + at, sizeof(section));
+    size_t padded = LIBRARY_SECTION_ALIGN((size_t)section.size);
+    if (padded > mf->size - at - sizeof(section)) return false;
+    const unsigned char *payload = data + at + sizeof(section);
+
+    if (section.tag == LIBRARY_SECTION_RECORDS) {
+      Library_File_Records records = {0};
+      if (section.size < sizeof(records)) return false;
+      memcpy(&records, payload, sizeof(records));
+      if (records.record_size < 2*sizeof(uint32_t)) return false;
+      if ((size_t)records.record_size*records.count != section.size - sizeof(records)) return false;
+      view->records = payload + sizeof(records);
+      view->record_size = records.record_size;
+      view->record_count = records.count;
+      has_records = true;
+    } else if (section.tag == LIBRARY_SECTION_STRINGS) {
+      view->strings = (const char *)payload;
+      view->strings_size = section.size;
+    } else if (section.tag == LIBRARY_SECTION_ORPHANS) {
+      if (section.size == 0 || payload[section.size - 1] != '\0') return false;
+      view->orphans = (const char *)payload;
+    } else if (section.tag == LIBRARY_SECTION_ORDER) {
+      Library_File_Order order = {0};
+      if (section.size < sizeof(order)) return false;
+      memcpy(&order, payload, sizeof(order));
+      if (sizeof(uint32_t)*order.count != section.size - sizeof(order)) return false;
+      // Modes from newer builds are sorted by them again anyway
+      if (order.mode < SORT_MODE_COUNT) {
+        view->orders[order.mode] = (const uint32_t *)(payload + sizeof(order));
+        order_counts[order.mode] = order.count;
+      }
+    } else if ((section.tag & 0xff) >= 'a' && (section.tag & 0xff) <= 'z') {
+      nob_sb_append_buf(kept, (const char *)data + at, sizeof(section) + padded);
+    }
+    at += sizeof(section) + padded;
+  }
+
+  if (!has_records) return false;
+  for (int mode = 0; mode < SORT_MODE_COUNT; ++mode) {
+    if (order_counts[mode] != view->record_count) view->orders[mode] = NULL;
+  }
+  if (!view->orphans) view->orphans = "";
+  return true;
+}
+
+// Everything is checked before anything is taken, a binary that doesn't hold up leaves the library untouched. The
+// saved orders are only used when every record is still at its index of the catalog
+bool library_load_binary(Library *lib, const char *path, Games *games, bool *aliased, bool *sorted) {
+  bool result = true;
+  Nob_String_Builder kept = {0};
+  Mapped_File mf = {0};
+  if (!map_file(path, &mf)) return false;
+
+  Library_File_View view = {0};
+  uint32_t header[2] = {0};
+  if (mf.size < sizeof(header)) nob_return_defer(false);
+  memcpy(header, mf.data, sizeof(header));
+  if (header[0] != LIBRARY_BINARY_MAGIC) nob_return_defer(false);
+  if (header[1] == 1 && !library_view_v1(&mf, &view)) nob_return_defer(false);
+  if (header[1] != 1 && !library_view_sections(&mf, &view, &kept)) nob_return_defer(false);
+
+  if (view.strings_size == 0 || view.strings[view.strings_size - 1] != '\0') nob_return_defer(false);
+  for (size_t i = 0; i < view.record_count; ++i) {
+    // Only the fields this build knows of are taken, the ones from older builds stay as they start
+    Library_File_Record record = { .extra = LIBRARY_NO_STRING };
+    memcpy(&record, view.records + i*view.record_size, MIN(view.record_size, sizeof(record)));
+    if (record.key >= view.strings_size) nob_return_defer(false);
+    if (record.alias != LIBRARY_NO_STRING && record.alias >= view.strings_size) nob_return_defer(false);
+    if (record.extra != LIBRARY_NO_STRING && record.extra >= view.strings_size) nob_return_defer(false);
+  }
+  *sorted = view.record_count == games->count;
+  // Records of games that went away merge into the sections kept already
+  nob_sb_append_cstr(&lib->orphans, view.orphans);
+
+  for (size_t i = 0; i < view.record_count; ++i) {
+    Library_File_Record record = { .extra = LIBRARY_NO_STRING };
+    memcpy(&record, view.records + i*view.record_size, MIN(view.record_size, sizeof(record)));
+    Game_Stats stats = {
+      .launches = record.launches,
+      .last_launch = record.last_launch,
+      .frecency = record.frecency,
+      .playtime = record.playtime,
+      .size = record.size,
+      .size_mtime = record.size_mtime,
+      .added = record.added,
+      .extra = record.extra != LIBRARY_NO_STRING ? intern_cstr(&title_interns, view.strings + record.extra) : NULL,
+    };
+    const char *key = view.strings + record.key;
+    const char *alias = record.alias != LIBRARY_NO_STRING ? view.strings + record.alias : NULL;
+    size_t index = library_find(lib, key);
+    if (index != i) *sorted = false;
+    if (index == SIZE_MAX) {
+      // The game went away since the save, it joins the other sections kept for later
+      library_orphan_put(&lib->orphans, key, alias, &stats);
+      continue;
+    }
+    lib->stats.items[index] = stats;
+    if (alias || games->items[index].alias) {
+      games->items[index].alias = alias ? intern_cstr(&title_interns, alias) : NULL;
+      *aliased = true;
+    }
+  }
+  lib->kept_sections.count = 0;
+  nob_sb_append_buf(&lib->kept_sections, kept.items, kept.count);
+
+  if (*sorted) {
+    // Has to be a permutation of the catalog, anything else and the orders are sorted again
+    bool *seen = malloc(sizeof(bool)*(games->count + 1));
+    NOB_ASSERT(seen != NULL && "Buy more RAM lol");
+    for (int mode = 0; mode < SORT_MODE_COUNT && *sorted; ++mode) {
+      const uint32_t *order = view.orders[mode];
+      if (!order) *sorted = false;
+      memset(seen, 0, sizeof(bool)*games->count);
+      for (size_t i = 0; i < games->count && *sorted; ++i) {
+        if (order[i] >= games->count || seen[order[i]]) *sorted = false;
+        else seen[order[i]] = true;
+      }
+    }
+    free(seen);
+  }
+  if (*sorted) {
+    for (int mode = 0; mode < SORT_MODE_COUNT; ++mode) {
+      const uint32_t *order = view.orders[mode];
+      nob_da_resize(&lib->orders[mode], games->count);
+      for (size_t i = 0; i < games->count; ++i) lib->orders[mode].items[i] = order[i];
+      lib->order_versions[mode] = game_view_next_version();
+    }
+  }
+
+defer:
+  unmap_file(&mf);
+  free(kept.items);
+  if (!result) nob_log(NOB_WARNING, "Ignoring invalid library %s", path);
+  return result;
+}
+
+// Returns where the section starts for library_end_section to fill in its size
+size_t library_begin_section(Nob_String_Builder *sb, uint32_t tag) {
+  size_t start = sb->count;
+  Library_File_Section section = { .tag = tag };
+  nob_sb_append_buf(sb, (const char *)&section, sizeof(section));
+  return start;
+}
+
+void library_end_section(Nob_String_Builder *sb, size_t start) {
+  Library_File_Section section = {0};
+  memcpy(&section, sb->items + start, sizeof(section));
+  section.size = (uint32_t)(sb->count - start - sizeof(section));
+  memcpy(sb->items + start, &section, sizeof(section));
+  while (sb->count % 8 != 0) nob_da_append(sb, '\0');
+}
+
+uint32_t library_add_string(Nob_String_Builder *strings, const char *string) {
+  uint32_t offset = (uint32_t)strings->count;
+  nob_sb_append_cstr(strings, string);
+  nob_sb_append_null(strings);
+  return offset;
+}
+
+bool library_save_binary(const Library *lib, const char *path, const Games *games) {
+  Library_File_Header header = { .magic = LIBRARY_BINARY_MAGIC, .version = LIBRARY_BINARY_VERSION };
+  Nob_String_Builder strings = {0};
+  Nob_String_Builder sb = {0};
+  nob_sb_append_buf(&sb, (const char *)&header, sizeof(header));
+
+  size_t section = library_begin_section(&sb, LIBRARY_SECTION_RECORDS);
+  Library_File_Records records = { .record_size = sizeof(Library_File_Record), .count = (uint32_t)games->count };
+  nob_sb_append_buf(&sb, (const char *)&records, sizeof(records));
+  for (size_t i = 0; i < games->count; ++i) {
+    const Game_Stats *stats = &lib->stats.items[i];
+    const char *alias = games->items[i].alias;
+    Library_File_Record record = {
+      .key = library_add_string(&strings, lib->keys.items[i]),
+      .alias = alias ? library_add_string(&strings, alias) : LIBRARY_NO_STRING,
+      .launches = stats->launches,
+      .last_launch = stats->last_launch,
+      .frecency = stats->frecency,
+      .playtime = stats->playtime,
+      .size = stats->size,
+      .size_mtime = stats->size_mtime,
+      .added = stats->added,
+      .extra = stats->extra ? library_add_string(&strings, stats->extra) : LIBRARY_NO_STRING,
+    };
+    nob_sb_append_buf(&sb, (const char *)&record, sizeof(record));
+  }
+  library_end_section(&sb, section);
+
+  for (int mode = 0; mode < SORT_MODE_COUNT; ++mode) {
+    NOB_ASSERT(lib->orders[mode].count == games->count);
+    section = library_begin_section(&sb, LIBRARY_SECTION_ORDER);
+    Library_File_Order order = { .mode = (uint32_t)mode, .count = (uint32_t)games->count };
+    nob_sb_append_buf(&sb, (const char *)&order, sizeof(order));
+    for (size_t i = 0; i < games->count; ++i) {
+      uint32_t index = (uint32_t)lib->orders[mode].items[i];
+      nob_sb_append_buf(&sb, (const char *)&index, sizeof(index));
+    }
+    library_end_section(&sb, section);
+  }
+
+  section = library_begin_section(&sb, LIBRARY_SECTION_STRINGS);
+  nob_sb_append_null(&strings);
+  nob_sb_append_buf(&sb, strings.items, strings.count);
+  library_end_section(&sb, section);
+
+  section = library_begin_section(&sb, LIBRARY_SECTION_ORPHANS);
+  nob_sb_append_buf(&sb, lib->orphans.items, lib->orphans.count);
+  nob_sb_append_null(&sb);
+  library_end_section(&sb, section);
+
+  nob_sb_append_buf(&sb, lib->kept_sections.items, lib->kept_sections.count);
+
+  header.size = (uint32_t)(sb.count - sizeof(header));
+  header.crc = ComputeCRC32((unsigned char *)sb.items + sizeof(header), (int)header.size);
+  memcpy(sb.items, &header, sizeof(header));
+
+  bool result = replace_file(path, sb.items, sb.count);
+  free(strings.items);
+  free(sb.items);
+  return result;
+}
+
+// The binary is only trusted when it was written at the same time as the text or after it. Modification times only
+// have seconds everywhere, an edit in the same second as a save is not noticed
+bool library_binary_is_current(const char *path, const char *binary_path) {
+  struct stat text = {0}, binary = {0};
+  if (stat(binary_path, &binary) != 0) return false;
+  if (stat(path, &text) != 0) return true;
+  return binary.st_mtime >= text.st_mtime;
+}
+
+typedef enum {
+  JOURNAL_ADDED = 1,
+  JOURNAL_LAUNCH,
+  JOURNAL_PLAYTIME,
+  JOURNAL_SIZE,
+  JOURNAL_ALIAS,
+} Journal_Kind;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+} Library_Journal_Header;
+
+// Every record is its size and the ComputeCRC32 of what follows, both uint32_t, then the kind as a byte, the payload
+// of that kind and the key of the game with its 0
+#define JOURNAL_RECORD_HEADER_SIZE (2*sizeof(uint32_t))
+
+typedef struct {
+  uint32_t launches;
+  uint32_t padding;
+  int64_t last_launch;
+  double frecency;
+} Journal_Launch;
+
+typedef struct {
+  uint64_t size;
+  int64_t size_mtime;
+} Journal_Size;
+
+void journal_append_record(Nob_String_Builder *sb, Journal_Kind kind, const char *key, const void *payload, size_t payload_size) {
+  uint32_t size = (uint32_t)(1 + payload_size + strlen(key) + 1);
+  uint32_t crc = 0;
+  size_t start = sb->count;
+  nob_sb_append_buf(sb, (const char *)&size, sizeof(size));
+  nob_sb_append_buf(sb, (const char *)&crc, sizeof(crc));
+  nob_da_append(sb, (char)kind);
+  nob_sb_append_buf(sb, payload, payload_size);
+  nob_sb_append_cstr(sb, key);
+  nob_sb_append_null(sb);
+  crc = ComputeCRC32((unsigned char *)sb->items + start + JOURNAL_RECORD_HEADER_SIZE, (int)size);
+  memcpy(sb->items + start + sizeof(size), &crc, sizeof(crc));
+}
+
+// The records that take a game from the stats in lib to the new ones, one per kind of change. They all carry the new
+// values instead of how much they changed so replaying one again over a library that already has it does nothing
+void journal_append_changes(Nob_String_Builder *sb, const Library *lib, const Games *games, size_t index, const Game_Stats *stats, const char *alias) {
+  const char *key = lib->keys.items[index];
+  const Game_Stats *old = &lib->stats.items[index];
+  if (old->added != stats->added) journal_append_record(sb, JOURNAL_ADDED, key, &stats->added, sizeof(stats->added));
+  if (old->launches != stats->launches || old->last_launch != stats->last_launch || old->frecency != stats->frecency) {
+    Journal_Launch launch = { .launches = stats->launches, .last_launch = stats->last_launch, .frecency = stats->frecency };
+    journal_append_record(sb, JOURNAL_LAUNCH, key, &launch, sizeof(launch));
+  }
+  if (old->playtime != stats->playtime) {
+    journal_append_record(sb, JOURNAL_PLAYTIME, key, &stats->playtime, sizeof(stats->playtime));
+  }
+  if (old->size != stats->size || old->size_mtime != stats->size_mtime) {
+    Journal_Size size = { .size = stats->size, .size_mtime = stats->size_mtime };
+    journal_append_record(sb, JOURNAL_SIZE, key, &size, sizeof(size));
+  }
+  if (games->items[index].alias != alias) {
+    const char *value = alias ? alias : "";
+    journal_append_record(sb, JOURNAL_ALIAS, key, value, strlen(value) + 1);
+  }
+}
+
+// Records of games that are not in the catalog gather here during a replay, a section per key, and go into the
+// orphans once at the end. Updating the orphans goes through all of their text, once per record is quadratic
+typedef struct {
+  char *key;
+  Nob_String_Builder section;
+} Journal_Orphan;
+
+typedef struct {
+  Journal_Orphan *items;
+  size_t count;
+  size_t capacity;
+} Journal_Orphans;
+
+Nob_String_Builder *journal_orphan_section(Journal_Orphans *orphans, const char *key) {
+  if (orphans->count*2 >= orphans->capacity) {
+    Journal_Orphans grown = {0};
+    grown.capacity = orphans->capacity ? orphans->capacity*2 : NOB_DA_INIT_CAP;
+    grown.items = calloc(grown.capacity, sizeof(*grown.items));
+    NOB_ASSERT(grown.items != NULL && "Buy more RAM lol");
+    for (size_t i = 0; i < orphans->capacity; ++i) {
+      if (!orphans->items[i].key) continue;
+      size_t j = hash_cstr(orphans->items[i].key) & (grown.capacity - 1);
+      while (grown.items[j].key) j = (j + 1) & (grown.capacity - 1);
+      grown.items[j] = orphans->items[i];
+      grown.count += 1;
+    }
+    free(orphans->items);
+    *orphans = grown;
+  }
+
+  size_t i = hash_cstr(key) & (orphans->capacity - 1);
+  while (orphans->items[i].key) {
+    if (streq(orphans->items[i].key, key)) return &orphans->items[i].section;
+    i = (i + 1) & (orphans->capacity - 1);
+  }
+  orphans->items[i].key = strdup(key);
+  orphans->count += 1;
+  return &orphans->items[i].section;
+}
+
+// Each section holds only its own key, so merging the fields of every record into it stays cheap
+void journal_orphans_flush(Journal_Orphans *orphans, Nob_String_Builder *into) {
+  for (size_t i = 0; i < orphans->capacity; ++i) {
+    Journal_Orphan *it = &orphans->items[i];
+    if (!it->key) continue;
+    Nob_String_View key = nob_sv_from_cstr(it->key);
+    size_t header = key.count + 4;
+    library_orphan_update(into, key, nob_sv_from_parts(it->section.items + header, it->section.count - header));
+    free(it->key);
+    free(it->section.items);
+  }
+  free(orphans->items);
+  *orphans = (Journal_Orphans) {0};
+}
+
+// Records of games that are not in the catalog go to their sections in pending, as the fields they change
+bool library_replay_record(Library *lib, Games *games, Journal_Orphans *pending, const unsigned char *body, size_t size, bool *aliased) {
+  Journal_Kind kind = body[0];
+  const unsigned char *payload = body + 1;
+  size_t payload_size = 0;
+  switch (kind) {
+    case JOURNAL_ADDED:
+    case JOURNAL_PLAYTIME: payload_size = sizeof(int64_t); break;
+    case JOURNAL_LAUNCH:   payload_size = sizeof(Journal_Launch); break;
+    case JOURNAL_SIZE:     payload_size = sizeof(Journal_Size); break;
+    case JOURNAL_ALIAS:    payload_size = strlen((const char *)payload) + 1; break;
+    // A newer build wrote it, whatever it changed this one does not have
+    default: return true;
+  }
+  if (1 + payload_size >= size) return false;
+  const char *key = (const char *)payload + payload_size;
+  if (strlen(key) != size - 2 - payload_size) return false;
+
+  Game_Stats stats = {0};
+  Journal_Launch launch = {0};
+  Journal_Size disk = {0};
+  if (kind == JOURNAL_ADDED) memcpy(&stats.added, payload, payload_size);
+  if (kind == JOURNAL_PLAYTIME) memcpy(&stats.playtime, payload, payload_size);
+  if (kind == JOURNAL_LAUNCH) memcpy(&launch, payload, payload_size);
+  if (kind == JOURNAL_SIZE) memcpy(&disk, payload, payload_size);
+  const char *alias = (const char *)payload;
+
+  size_t index = library_find(lib, key);
+  if (index == SIZE_MAX) {
+    Nob_String_Builder fields = {0};
+    Nob_String_Builder *sb = &fields;
+    switch (kind) {
+      case JOURNAL_ADDED:    nob_sb_appendf(sb, "added = %lld\n", (long long)stats.added); break;
+      case JOURNAL_PLAYTIME: nob_sb_appendf(sb, "playtime = %lld\n", (long long)stats.playtime); break;
+      case JOURNAL_LAUNCH:
+        nob_sb_appendf(sb, "launches = %u\nlast_launch = %lld\nfrecency = %.17g\n",
+                       launch.launches, (long long)launch.last_launch, launch.frecency);
+        break;
+      case JOURNAL_SIZE:
+        nob_sb_appendf(sb, "size = %llu\nsize_mtime = %lld\n", (unsigned long long)disk.size, (long long)disk.size_mtime);
+        break;
+      case JOURNAL_ALIAS:    nob_sb_appendf(sb, "alias = %s\n", alias); break;
+      default:               NOB_UNREACHABLE("library_replay_record");
+    }
+    library_orphan_update(journal_orphan_section(pending, key), nob_sv_from_cstr(key), nob_sb_to_sv(fields));
+    free(fields.items);
+    return true;
+  }
+
+  Game_Stats *current = &lib->stats.items[index];
+  switch (kind) {
+    case JOURNAL_ADDED:    current->added = stats.added; break;
+    case JOURNAL_PLAYTIME: current->playtime = stats.playtime; break;
+    case JOURNAL_LAUNCH:
+      current->launches = launch.launches;
+      current->last_launch = launch.last_launch;
+      current->frecency = launch.frecency;
+      break;
+    case JOURNAL_SIZE:
+      current->size = disk.size;
+      current->size_mtime = disk.size_mtime;
+      break;
+    case JOURNAL_ALIAS:
+      games->items[index].alias = alias[0] != '\0' ? intern_cstr(&title_interns, alias) : NULL;
+      *aliased = true;
+      break;
+    default: NOB_UNREACHABLE("library_replay_record");
+  }
+  return true;
+}
+
+// Goes over the records of a journal read whole into data, from offset from on, on top of what lib has. It stops at
+// the first record that does not hold up and returns where the good ones end, 0 when data is not a journal at all
+size_t library_replay_journal_data(Library *lib, Games *games, const char *path, const unsigned char *data, size_t data_size, size_t from, bool *aliased, bool *replayed) {
+  Library_Journal_Header header = {0};
+  if (data_size >= sizeof(header)) memcpy(&header, data, sizeof(header));
+  // Any version goes, what a version adds are new kinds of records
+  if (header.magic != LIBRARY_JOURNAL_MAGIC) {
+    if (data_size > 0) nob_log(NOB_WARNING, "%s is not a journal lzua can read, ignoring it", path);
+    return 0;
+  }
+
+  Journal_Orphans pending = {0};
+  size_t at = MAX(from, sizeof(header));
+  while (data_size - at >= JOURNAL_RECORD_HEADER_SIZE) {
+    uint32_t size = 0, crc = 0;
+    memcpy(&size, data + at, sizeof(size));
+    memcpy(&crc, data + at + sizeof(size), sizeof(crc));
+    if (size < 2 || size > data_size - at - JOURNAL_RECORD_HEADER_SIZE) break;
+    const unsigned char *body = data + at + JOURNAL_RECORD_HEADER_SIZE;
+    if (body[size - 1] != '\0' || ComputeCRC32((unsigned char *)body, (int)size) != crc) break;
+    if (!library_replay_record(lib, games, &pending, body, size, aliased)) break;
+    at += JOURNAL_RECORD_HEADER_SIZE + size;
+    *replayed = true;
+  }
+  journal_orphans_flush(&pending, &lib->orphans);
+  return at;
+}
+
+// Replays the open journal from offset from on. What does not hold up at its end can only be an append cut short by
+// an instance that died in the middle of it, the lock keeps a live one from being seen halfway. It is cut off, or the
+// records appended after it would never replay
+size_t library_replay_locked_journal(Library *lib, Games *games, Locked_File *journal, const char *path, size_t from, bool *aliased, bool *replayed) {
+  Nob_String_Builder data = {0};
+  if (!locked_file_read(journal, &data)) {
+    nob_log(NOB_WARNING, "Could not read %s", path);
+    free(data.items);
+    return from;
+  }
+  size_t good = library_replay_journal_data(lib, games, path, (const unsigned char *)data.items, data.count, from, aliased, replayed);
+  if (good < data.count) {
+    nob_log(NOB_WARNING, "%s: dropping %zu bytes that do not hold up at its end", path, data.count - good);
+    if (!locked_file_truncate(journal, good)) nob_log(NOB_WARNING, "Could not cut %s short", path);
+  }
+  free(data.items);
+  return good;
+}
+
+// Returns how much of the journal is good, which is where appends go
+size_t library_replay_journal(Library *lib, const char *path, Games *games, bool *aliased, bool *replayed) {
+  Locked_File journal = {0};
+  if (nob_file_exists(path) != 1 || !locked_file_open(&journal, path, false)) return 0;
+  size_t good = library_replay_locked_journal(lib, games, &journal, path, 0, aliased, replayed);
+  locked_file_close(&journal);
+  return good;
+}
+
+bool library_load(Library *lib, const char *path, const char *binary_path, const char *journal_path, Games *games) {
+  free(library_index_catalog(lib, games));
+
+  bool aliased = false;
+  bool sorted = false;
+  bool compile = false;
+  bool result = true;
+  if (!library_binary_is_current(path, binary_path) || !library_load_binary(lib, binary_path, games, &aliased, &sorted)) {
+    result = library_parse_text(lib, path, games, &aliased);
+    compile = result && nob_file_exists(path) == 1;
+  }
+  bool replayed = false;
+  lib->journal_size = library_replay_journal(lib, journal_path, games, &aliased, &replayed);
+  if (replayed) sorted = false;
+
+  if (aliased) games->version += 1;
+  lib->catalog_version = games->version;
+  for (size_t i = 0; i < games->count; ++i) sorted &= !library_stamp_new(lib, i);
+  if (sorted) {
+    for (size_t i = 0; i < games->count; ++i) {
+      lib->titles.items[i] = game_title(&games->items[i]);
+      lib->name_prefixes.items[i] = name_prefix(lib->titles.items[i], 0);
+    }
+    sorted = library_orders_sorted(lib);
+  }
+  if (sorted) {
+    library_build_recent(lib);
+  } else {
+    library_build_orders(lib);
+  }
+  library_meta_build(&lib->meta, lib);
+  if (compile && !library_save_binary(lib, binary_path, games)) {
+    nob_log(NOB_WARNING, "Could not compile %s to %s", path, binary_path);
+  }
+  return result;
+}
+
+// The text first so the binary ends up the newer of the two
+bool library_save(const Library *lib, const char *path, const char *binary_path, const Games *games) {
+  Nob_String_Builder sb = {0};
+  nob_sb_append_cstr(&sb, "# Written by lzua, one section per game\n");
+  for (size_t i = 0; i < games->count; ++i) {
+    library_append_section(&sb, lib->keys.items[i], games->items[i].alias, &lib->stats.items[i]);
+  }
+  nob_sb_append_buf(&sb, lib->orphans.items, lib->orphans.count);
+
+  bool result = replace_file(path, sb.items, sb.count);
+  free(sb.items);
+  return result && library_save_binary(lib, binary_path, games);
+}
+
+void library_free(Library *lib) {
+  free(lib->stats.items);
+  free(lib->keys.items);
+  free(lib->titles.items);
+  free(lib->name_prefixes.items);
+  free(lib->lookup);
+  for (int mode = 0; mode < SORT_MODE_COUNT; ++mode) free(lib->orders[mode].items);
+  free(lib->recent.items);
+  free(lib->orphans.items);
+  free(lib->changes.items);
+  free(lib->kept_sections.items);
+  library_meta_free(&lib->meta);
+  *lib = (Library) {0};
+}
+
+// Queries whose first word is a filter, see search_is_filter, are compiled into a list of ops over the columns of
+// Library_Meta, like
+//
+//   tag:coop size>10G played<30d -genre:horror rating>=8 hollow
+//
+// Every op narrows a bitset of the catalog down in one tight loop over its column, and the words that are not filters
+// have to be somewhere in the title, alias or executable. Sizes take K, M, G and T, durations s, m, h, d, w and y,
+// plain numbers are bytes and seconds. played and added are how long ago that happened. A minus in front negates
+typedef enum {
+  FILTER_TAG,
+  FILTER_ID,
+  FILTER_LESS,
+  FILTER_LESS_EQUAL,
+  FILTER_GREATER,
+  FILTER_GREATER_EQUAL,
+  FILTER_EQUAL,
+  // Asked for a tag or value nobody has
+  FILTER_NOTHING,
+} Filter_Opcode;
+
+typedef struct {
+  Filter_Opcode code;
+  bool negate;
+  const uint64_t *bits;
+  const double *numbers;
+  double number;
+  const uint32_t *ids;
+  uint32_t id;
+} Filter_Op;
+
+typedef struct {
+  Nob_String_Builder query;
+  List(Filter_Op) ops;
+  // Folded words that are not filters, each one ended by a zero
+  Nob_String_Builder words;
+  List(uint64_t) bits;
+  Game_Indices hits;
+  // What the hits were made from
+  size_t meta_version;
+  size_t order_version;
+  Sort_Mode sort;
+  size_t version;
+} Filter;
+
+typedef enum {
+  FILTER_UNIT_NONE,
+  FILTER_UNIT_BYTES,
+  FILTER_UNIT_SECONDS,
+} Filter_Unit;
+
+// Plain number followed by an optional unit, false when it is not one
+bool filter_parse_number(Nob_String_View sv, Filter_Unit unit, double *number) {
+  size_t save = nob_temp_save();
+  const char *text = nob_temp_sv_to_cstr(sv);
+  char *end = NULL;
+  double value = strtod(text, &end);
+  bool ok = end != text;
+  double scale = 1;
+  char suffix = fold_ascii(*end);
+  if (ok && suffix != '\0') {
+    if (unit == FILTER_UNIT_BYTES) {
+      const char *units = "kmgt";
+      const char *at = strchr(units, suffix);
+      ok = at != NULL;
+      if (ok) scale = pow(1024, at - units + 1);
+      end += 1;
+      // 10G, 10GB and 10GiB all go
+      if (fold_ascii(*end) == 'i') end += 1;
+      if (fold_ascii(*end) == 'b') end += 1;
+    } else if (unit == FILTER_UNIT_SECONDS) {
+      switch (suffix) {
+        case 's': scale = 1; break;
+        case 'm': scale = 60; break;
+        case 'h': scale = 60*60; break;
+        case 'd': scale = 24*60*60; break;
+        case 'w': scale = 7*24*60*60; break;
+        case 'y': scale = 365*24*60*60; break;
+        default: ok = false;
+      }
+      end += 1;
+    } else {
+      ok = false;
+    }
+    ok = ok && *end == '\0';
+  }
+  nob_temp_rewind(save);
+  *number = value*scale;
+  return ok;
+}
+
+// Ages compare the other way around against the time they happened at
+Filter_Opcode filter_flip(Filter_Opcode code) {
+  switch (code) {
+    case FILTER_LESS:          return FILTER_GREATER;
+    case FILTER_LESS_EQUAL:    return FILTER_GREATER_EQUAL;
+    case FILTER_GREATER:       return FILTER_LESS;
+    case FILTER_GREATER_EQUAL: return FILTER_LESS_EQUAL;
+    default:                   return code;
+  }
+}
+
+// Returns false for a word that is not a filter, which then goes with the text words. A filter that is still being
+// typed, like tag: with nothing after it, compiles to nothing
+bool filter_compile_word(Filter *filter, Nob_String_View word, const Library_Meta *meta, int64_t now) {
+  bool negate = word.count > 1 && word.data[0] == '-';
+  if (negate) nob_sv_chop_left(&word, 1);
+  size_t len = 0;
+  while (len < word.count && search_is_field_char(word.data[len])) len += 1;
+  if (len == 0 || len == word.count) return false;
+
+  Nob_String_View name = nob_sv_from_parts(word.data, len);
+  nob_sv_chop_left(&word, len);
+  Filter_Opcode code;
+  bool equals = false;
+  if (nob_sv_starts_with(word, nob_sv_from_cstr("<="))) code = FILTER_LESS_EQUAL;
+  else if (nob_sv_starts_with(word, nob_sv_from_cstr(">="))) code = FILTER_GREATER_EQUAL;
+  else if (word.data[0] == '<') code = FILTER_LESS;
+  else if (word.data[0] == '>') code = FILTER_GREATER;
+  else if (word.data[0] == '=' || word.data[0] == ':') {
+    code = FILTER_EQUAL;
+    equals = true;
+  } else {
+    return false;
+  }
+  nob_sv_chop_left(&word, code == FILTER_LESS_EQUAL || code == FILTER_GREATER_EQUAL ? 2 : 1);
+
+  size_t save = nob_temp_save();
+  const char *field = meta_fold_temp(name);
+  const char *value = meta_fold_temp(word);
+  Filter_Op op = { .code = code, .negate = negate };
+  Filter_Unit unit = FILTER_UNIT_NONE;
+  bool age = false;
+  bool known = true;
+  if (streq(field, "tag") && equals) {
+    uint32_t tag = meta_dictionary_find(&meta->tags, value);
+    op.code = FILTER_TAG;
+    if (tag == UINT32_MAX || (size_t)(tag + 1)*meta->words > meta->tag_bits.count) op.code = FILTER_NOTHING;
+    else op.bits = meta->tag_bits.items + (size_t)tag*meta->words;
+  } else if (streq(field, "size")) {
+    op.numbers = meta->builtins[META_SIZE].items;
+    unit = FILTER_UNIT_BYTES;
+  } else if (streq(field, "playtime")) {
+    op.numbers = meta->builtins[META_PLAYTIME].items;
+    unit = FILTER_UNIT_SECONDS;
+  } else if (streq(field, "launches")) {
+    op.numbers = meta->builtins[META_LAUNCHES].items;
+  } else if (streq(field, "played")) {
+    op.numbers = meta->builtins[META_LAST_LAUNCH].items;
+    unit = FILTER_UNIT_SECONDS;
+    age = true;
+  } else if (streq(field, "added")) {
+    op.numbers = meta->builtins[META_ADDED].items;
+    unit = FILTER_UNIT_SECONDS;
+    age = true;
+  } else {
+    uint32_t column = meta_dictionary_find(&meta->column_names, field);
+    known = column != UINT32_MAX;
+    if (known) {
+      op.numbers = meta->columns.items[column].numbers.items;
+      op.ids = meta->columns.items[column].ids.items;
+    }
+  }
+
+  if (known && op.numbers && value[0] != '\0') {
+    if (filter_parse_number(word, unit, &op.number)) {
+      if (age) {
+        op.number = (double)now - op.number;
+        op.code = filter_flip(op.code);
+      }
+      op.ids = NULL;
+    } else if (equals && op.ids) {
+      op.code = FILTER_ID;
+      op.id = meta_dictionary_find(&meta->values, value);
+      if (op.id == UINT32_MAX) op.code = FILTER_NOTHING;
+    } else {
+      op.code = FILTER_NOTHING;
+    }
+  }
+  if (known && value[0] != '\0') nob_da_append(&filter->ops, op);
+  nob_temp_rewind(save);
+  return known;
+}
+
+void filter_compile(Filter *filter, const Library_Meta *meta, int64_t now) {
+  filter->ops.count = 0;
+  filter->words.count = 0;
+  Nob_String_View sv = nob_sb_to_sv(filter->query);
+  while (sv.count > 0) {
+    Nob_String_View word = nob_sv_chop_by_delim(&sv, ' ');
+    if (word.count == 0 || filter_compile_word(filter, word, meta, now)) continue;
+    for (size_t i = 0; i < word.count; ++i) nob_da_append(&filter->words, fold_ascii(word.data[i]));
+    nob_da_append(&filter->words, '\0');
+  }
+}
+
+// The mask of the 64 games of every word of the bitset in one go, so the compare has nothing else in its loop
+#define FILTER_COMPARE_LOOP(compare)                                 \
+  do {                                                               \
+    for (size_t w = 0; w < words; ++w) {                             \
+      if (bits[w] == 0) continue;                                    \
+      const double *column = op->numbers + w*64;                     \
+      size_t n = MIN(64, count - w*64);                              \
+      uint64_t mask = 0;                                             \
+      for (size_t b = 0; b < n; ++b) {                               \
+        mask |= (uint64_t)(column[b] compare op->number) << b;       \
+      }                                                              \
+      bits[w] &= op->negate ? ~mask : mask;                          \
+    }                                                                \
+  } while (0)
+
+void filter_run_op(const Filter_Op *op, uint64_t *bits, size_t words, size_t count) {
+  switch (op->code) {
+    case FILTER_TAG:
+      for (size_t w = 0; w < words; ++w) bits[w] &= op->negate ? ~op->bits[w] : op->bits[w];
+      break;
+    case FILTER_ID:
+      for (size_t w = 0; w < words; ++w) {
+        if (bits[w] == 0) continue;
+        const uint32_t *ids = op->ids + w*64;
+        size_t n = MIN(64, count - w*64);
+        uint64_t mask = 0;
+        for (size_t b = 0; b < n; ++b) mask |= (uint64_t)(ids[b] == op->id) << b;
+        bits[w] &= op->negate ? ~mask : mask;
+      }
+      break;
+    case FILTER_LESS:          FILTER_COMPARE_LOOP(<);  break;
+    case FILTER_LESS_EQUAL:    FILTER_COMPARE_LOOP(<=); break;
+    case FILTER_GREATER:       FILTER_COMPARE_LOOP(>);  break;
+    case FILTER_GREATER_EQUAL: FILTER_COMPARE_LOOP(>=); break;
+    case FILTER_EQUAL:         FILTER_COMPARE_LOOP(==); break;
+    case FILTER_NOTHING:
+      if (!op->negate) memset(bits, 0, sizeof(uint64_t)*words);
+      break;
+    default: NOB_UNREACHABLE("filter_run_op");
+  }
+}
+
+// The games that pass, in the order of the sort mode of the library
+void filter_run(Filter *filter, const Search *search, const Library *lib) {
+  const Library_Meta *meta = &lib->meta;
+  size_t words = meta->words;
+  nob_da_resize(&filter->bits, words);
+  memset(filter->bits.items, 0xff, sizeof(uint64_t)*words);
+  if (meta->count%64 != 0) filter->bits.items[words - 1] = (1ULL << (meta->count%64)) - 1;
+  for (size_t i = 0; i < filter->ops.count; ++i) {
+    filter_run_op(&filter->ops.items[i], filter->bits.items, words, meta->count);
+  }
+
+  filter->hits.count = 0;
+  const Game_Indices *order = &lib->orders[lib->sort];
+  for (size_t i = 0; i < order->count; ++i) {
+    size_t index = order->items[i];
+    if (index >= meta->count || !(filter->bits.items[index/64] >> (index%64) & 1)) continue;
+    bool found = true;
+    for (size_t at = 0; at < filter->words.count && found; at += strlen(filter->words.items + at) + 1) {
+      const char *word = filter->words.items + at;
+      found = search_exact_score(search, index, word, strlen(word)) >= 0;
+    }
+    if (found) nob_da_append(&filter->hits, index);
+  }
+  filter->meta_version = meta->version;
+  filter->order_version = lib->order_versions[lib->sort];
+  filter->sort = lib->sort;
+  filter->version = game_view_next_version();
+}
+
+// Compiles the query again when it changed and runs it again when the library did
+Game_View filter_view(Filter *filter, const Search *search, const Library *lib) {
+  bool compiled = filter->query.count == search->query.count
+    && memcmp(filter->query.items, search->query.items, search->query.count) == 0;
+  if (!compiled) {
+    filter->query.count = 0;
+    nob_sb_append_buf(&filter->query, search->query.items, search->query.count);
+    filter_compile(filter, &lib->meta, (int64_t)time(NULL));
+  }
+  if (!compiled || filter->meta_version != lib->meta.version || filter->sort != lib->sort
+      || filter->order_version != lib->order_versions[lib->sort]) {
+    filter_run(filter, search, lib);
+  }
+  return (Game_View) { .items = filter->hits.items, .count = filter->hits.count, .version = filter->version };
+}
+
+void filter_free(Filter *filter) {
+  free(filter->query.items);
+  free(filter->ops.items);
+  free(filter->words.items);
+  free(filter->bits.items);
+  free(filter->hits.items);
+  *filter = (Filter) {0};
+}
+
+// Saving the library happens on its own thread so the disk never holds up a frame. The render thread only hands it
+// the new stats of the games that changed, and the thread applies them to its own copy of the library, which keeps
+// that copy sorted for the binary. Changes are gathered until none came in for PERSIST_DEBOUNCE_MS, or for at most
+// PERSIST_MAX_DELAY_MS while they keep coming, and then appended to the journal in one go. The journal is always
+// written before the library files, so replaying what is left of it over newer files gives the same values
+#define PERSIST_DEBOUNCE_MS 1500
+#define PERSIST_MAX_DELAY_MS 10000
+
+typedef struct {
+  size_t index;
+  Game_Stats stats;
+  // Interned, NULL for no alias
+  const char *alias;
+} Library_Change;
+
+typedef List(Library_Change) Library_Changes;
+
+typedef struct {
+  Thread thread;
+  bool running;
+  Mutex mutex;
+  Cond cond;
+  Library_Changes pending;
+  // Counts what was submitted so the debounce can tell whether anything came in while it waited
+  size_t submits;
+  // The whole library has to be written, not just journaled
+  bool compact;
+  // Replaces the copy when the catalog itself changed, along with the games it points to
+  Library *snapshot;
+  Games snapshot_games;
+  bool quit;
+  // Only touched by the render thread
+  size_t catalog_version;
+  // Only touched by the persister thread once it runs
+  Library mirror;
+  Games games;
+  const char *path;
+  const char *binary_path;
+  const char *journal_path;
+  size_t journal_size;
+} Persister;
+
+// Enough of a copy to save from, the strings are interned or owned by the catalog and outlive both
+void library_copy(Library *dst, Games *dst_games, const Library *src, const Games *src_games) {
+  *dst_games = (Games) { .version = src_games->version };
+  nob_da_append_many(dst_games, src_games->items, src_games->count);
+  *dst = (Library) { .games = dst_games, .catalog_version = src->catalog_version, .sort = src->sort };
+  nob_da_append_many(&dst->stats, src->stats.items, src->stats.count);
+  nob_da_append_many(&dst->keys, src->keys.items, src->keys.count);
+  nob_da_append_many(&dst->titles, src->titles.items, src->titles.count);
+  nob_da_append_many(&dst->name_prefixes, src->name_prefixes.items, src->name_prefixes.count);
+  if (src->lookup_capacity > 0) {
+    dst->lookup = malloc(sizeof(size_t)*src->lookup_capacity);
+    NOB_ASSERT(dst->lookup != NULL && "Buy more RAM lol");
+    memcpy(dst->lookup, src->lookup, sizeof(size_t)*src->lookup_capacity);
+    dst->lookup_capacity = src->lookup_capacity;
+  }
+  for (int mode = 0; mode < SORT_MODE_COUNT; ++mode) {
+    nob_da_append_many(&dst->orders[mode], src->orders[mode].items, src->orders[mode].count);
+  }
+  nob_sb_append_buf(&dst->orphans, src->orphans.items, src->orphans.count);
+  nob_sb_append_buf(&dst->kept_sections, src->kept_sections.items, src->kept_sections.count);
+}
+
+void library_apply_change(Library *lib, Games *games, const Library_Change *change) {
+  if (change->index >= lib->stats.count) return;
+  size_t positions[SORT_MODE_COUNT];
+  library_reorder_begin(lib, change->index, positions);
+  lib->stats.items[change->index] = change->stats;
+  games->items[change->index].alias = change->alias;
+  lib->titles.items[change->index] = game_title(&games->items[change->index]);
+  lib->name_prefixes.items[change->index] = name_prefix(lib->titles.items[change->index], 0);
+  library_reorder_end(lib, change->index, positions);
+}
+
+// Other instances on the same games directory may have appended to the journal since this one last held its lock,
+// or compacted it and started over. Whatever they appended goes into the mirror too, so compacting here keeps it
+void persister_catch_up(Persister *persister, Locked_File *journal) {
+  size_t size = 0;
+  if (!locked_file_size(journal, &size) || size == persister->journal_size) return;
+  // Shorter means it was emptied since, everything in it now is theirs
+  size_t from = size > persister->journal_size ? persister->journal_size : 0;
+  Library *mirror = &persister->mirror;
+  bool aliased = false, replayed = false;
+  persister->journal_size = library_replay_locked_journal(mirror, &persister->games, journal, persister->journal_path,
+                                                          from, &aliased, &replayed);
+  if (persister->journal_size == 0 && size > 0 && !locked_file_truncate(journal, 0)) {
+    nob_log(NOB_WARNING, "Could not empty %s", persister->journal_path);
+  }
+  if (replayed) library_build_orders(mirror);
+}
+
+// The journal stays locked from catching up to appending and, when it compacts, until it is emptied, so no other
+// instance appends anything in between that the saved files would not have
+void persister_write(Persister *persister, Library_Changes *changes, bool compact) {
+  Library *mirror = &persister->mirror;
+  Locked_File journal = {0};
+  bool locked = locked_file_open(&journal, persister->journal_path, true);
+  if (locked) persister_catch_up(persister, &journal);
+
+  Nob_String_Builder records = {0};
+  if (persister->journal_size == 0) {
+    Library_Journal_Header header = { .magic = LIBRARY_JOURNAL_MAGIC, .version = LIBRARY_JOURNAL_VERSION };
+    nob_sb_append_buf(&records, (const char *)&header, sizeof(header));
+  }
+  size_t header_size = records.count;
+  for (size_t i = 0; i < changes->count; ++i) {
+    const Library_Change *change = &changes->items[i];
+    if (change->index >= mirror->stats.count) continue;
+    journal_append_changes(&records, mirror, &persister->games, change->index, &change->stats, change->alias);
+    library_apply_change(mirror, &persister->games, change);
+  }
+  changes->count = 0;
+
+  if (records.count > header_size) {
+    if (locked && locked_file_append(&journal, records.items, records.count)) {
+      persister->journal_size += records.count;
+    } else {
+      nob_log(NOB_WARNING, "Could not append to %s, saving the whole library instead", persister->journal_path);
+      compact = true;
+    }
+  }
+  free(records.items);
+
+  if (compact || persister->journal_size > LIBRARY_JOURNAL_LIMIT) {
+    if (!library_save(mirror, persister->path, persister->binary_path, &persister->games)) {
+      nob_log(NOB_WARNING, "Could not save the library to %s", persister->path);
+    } else if (locked && persister->journal_size > 0) {
+      // Only emptied once the files have everything it had
+      if (locked_file_truncate(&journal, 0)) persister->journal_size = 0;
+    }
+  }
+  if (locked) locked_file_close(&journal);
+}
+
+void persister_loop(void *arg) {
+  Persister *persister = arg;
+  Library_Changes taken = {0};
+  mutex_lock(&persister->mutex);
+  for (;;) {
+    while (!persister->quit && persister->pending.count == 0 && !persister->compact) {
+      cond_wait(&persister->cond, &persister->mutex);
+    }
+    if (persister->pending.count == 0 && !persister->compact) break;
+
+    // Quitting skips the wait, whatever is pending gets written right away
+    uint64_t first = nob_nanos_since_unspecified_epoch();
+    while (!persister->quit) {
+      size_t submits = persister->submits;
+      cond_timed_wait(&persister->cond, &persister->mutex, PERSIST_DEBOUNCE_MS);
+      if (persister->submits == submits) break;
+      if (nob_nanos_since_unspecified_epoch() - first >= PERSIST_MAX_DELAY_MS*1000000ULL) break;
+    }
+
+    Library *snapshot = persister->snapshot;
+    Games snapshot_games = persister->snapshot_games;
+    persister->snapshot = NULL;
+    Library_Changes swap = persister->pending;
+    persister->pending = taken;
+    taken = swap;
+    bool compact = persister->compact;
+    persister->compact = false;
+    mutex_unlock(&persister->mutex);
+
+    if (snapshot) {
+      library_free(&persister->mirror);
+      free(persister->games.items);
+      persister->mirror = *snapshot;
+      persister->games = snapshot_games;
+      persister->mirror.games = &persister->games;
+      free(snapshot);
+    }
+    persister_write(persister, &taken, compact);
+    mutex_lock(&persister->mutex);
+  }
+  mutex_unlock(&persister->mutex);
+  free(taken.items);
+}
+
+// Starts from a copy of the library as it is now, which gets written soon if loading it already changed it
+void persister_start(Persister *persister, Library *lib, const Games *games, const char *path, const char *binary_path, const char *journal_path) {
+  mutex_init(&persister->mutex);
+  cond_init(&persister->cond);
+  persister->path = path;
+  persister->binary_path = binary_path;
+  persister->journal_path = journal_path;
+  persister->journal_size = lib->journal_size;
+  persister->catalog_version = lib->catalog_version;
+  library_copy(&persister->mirror, &persister->games, lib, games);
+  persister->mirror.games = &persister->games;
+  persister->compact = lib->changes.count > 0;
+  lib->changes.count = 0;
+  persister->running = thread_spawn(&persister->thread, persister_loop, persister);
+  if (!persister->running) nob_log(NOB_WARNING, "Could not start the persister thread, saving on the render thread");
+}
+
+// Hands what changed since the last call to the persister, cheap enough to call every frame
+void persister_submit(Persister *persister, Library *lib, const Games *games) {
+  bool resync = persister->catalog_version != lib->catalog_version;
+  if (lib->changes.count == 0 && !resync) return;
+
+  Library *snapshot = NULL;
+  Games snapshot_games = {0};
+  if (resync) {
+    persister->catalog_version = lib->catalog_version;
+    snapshot = malloc(sizeof(*snapshot));
+    NOB_ASSERT(snapshot != NULL && "Buy more RAM lol");
+    library_copy(snapshot, &snapshot_games, lib, games);
+  }
+
+  mutex_lock(&persister->mutex);
+  if (snapshot) {
+    // The new copy already has every change so far
+    if (persister->snapshot) {
+      library_free(persister->snapshot);
+      free(persister->snapshot);
+      free(persister->snapshot_games.items);
+    }
+    persister->snapshot = snapshot;
+    persister->snapshot_games = snapshot_games;
+    persister->pending.count = 0;
+    persister->compact = true;
+  } else {
+    for (size_t i = 0; i < lib->changes.count; ++i) {
+      size_t index = lib->changes.items[i];
+      Library_Change change = { .index = index, .stats = lib->stats.items[index], .alias = games->items[index].alias };
+      nob_da_append(&persister->pending, change);
+    }
+  }
+  persister->submits += 1;
+  cond_signal(&persister->cond);
+  mutex_unlock(&persister->mutex);
+  lib->changes.count = 0;
+
+  if (!persister->running) {
+    // Same as the thread would do, only without waiting for more
+    bool compact = persister->compact;
+    persister->compact = false;
+    if (persister->snapshot) {
+      library_free(&persister->mirror);
+      free(persister->games.items);
+      persister->mirror = *persister->snapshot;
+      persister->games = persister->snapshot_games;
+      persister->mirror.games = &persister->games;
+      free(persister->snapshot);
+      persister->snapshot = NULL;
+    }
+    persister_write(persister, &persister->pending, compact);
+  }
+}
+
+// Writes whatever is still pending before returning
+void persister_stop(Persister *persister) {
+  if (persister->running) {
+    mutex_lock(&persister->mutex);
+    persister->quit = true;
+    cond_broadcast(&persister->cond);
+    mutex_unlock(&persister->mutex);
+    thread_join(persister->thread);
+  }
+  if (persister->snapshot) {
+    library_free(persister->snapshot);
+    free(persister->snapshot);
+    free(persister->snapshot_games.items);
+  }
+  library_free(&persister->mirror);
+  free(persister->games.items);
+  free(persister->pending.items);
+  *persister = (Persister) {0};
+}
+
+// How much disk every game takes, measured in the background. Only a couple of threads walk at a time so the disk
+// is still usable for everything else, and they stop walking while a game runs so it gets the disk to itself.
+// A folder whose mtime did not change since it was last measured keeps its size from the library
+#define DISK_WALK_THREADS 2
+
+typedef struct {
+  size_t index;
+  uint64_t size;
+  int64_t mtime;
+} Disk_Size;
+
+typedef List(Disk_Size) Disk_Sizes;
+
+// A file with more than one link is only counted once per game, whatever the name it was found by
+typedef struct {
+  uint64_t dev;
+  uint64_t ino;
+  uint64_t size;
+} Disk_Link;
+
+typedef List(Disk_Link) Disk_Links;
+
+typedef struct {
+  Worker_Pool pool;
+  Mutex mutex;
+  Cond resume;
+  bool paused;
+  bool quit;
+  // Folders and what the library knew about them when the walk started, indexed like the catalog
+  const char **folders;
+  int64_t *known_mtimes;
+  size_t count;
+  size_t next;
+  size_t remaining;
+  Disk_Sizes results;
+} Disk_Walker;
+
+// Blocks while paused. Returns false when the walker is shutting down
+bool disk_walker_wait(Disk_Walker *walker) {
+  mutex_lock(&walker->mutex);
+  while (walker->paused && !walker->quit) cond_wait(&walker->resume, &walker->mutex);
+  bool go_on = !walker->quit;
+  mutex_unlock(&walker->mutex);
+  return go_on;
+}
+
+int compare_disk_links(const void *a, const void *b) {
+  const Disk_Link *x = a, *y = b;
+  if (x->dev != y->dev) return x->dev < y->dev ? -1 : 1;
+  return (x->ino > y->ino) - (x->ino < y->ino);
+}
+
+#ifdef _WIN32
+// No inodes to go by here, hardlinks count once per name. The compressed size is what sparse and compressed files
+// really take. nob_read_entire_dir keeps the names in the temp arena, which is not ours to touch from this thread
+bool disk_walk_dir(Disk_Walker *walker, const char *path, uint64_t *size, Disk_Links *links) {
+  (void) links;
+  DIR *dir = opendir(path);
+  if (!dir) return true;
+  bool go_on = true;
+  struct dirent *entry;
+  while (go_on && (entry = readdir(dir)) != NULL) {
+    const char *name = entry->d_name;
+    if (streq(name, ".") || streq(name, "..")) continue;
+    go_on = disk_walker_wait(walker);
+    Nob_String_Builder child = {0};
+    nob_sb_appendf(&child, "%s\\%s", path, name);
+    nob_sb_append_null(&child);
+    DWORD attributes = GetFileAttributesA(child.items);
+    if (attributes == INVALID_FILE_ATTRIBUTES || (attributes & FILE_ATTRIBUTE_REPARSE_POINT)) {
+      // Not following junctions, same as not following symlinks
+    } else if (attributes & FILE_ATTRIBUTE_DIRECTORY) {
+      go_on = go_on && disk_walk_dir(walker, child.items, size, links);
+    } else {
+      DWORD high = 0;
+      DWORD low = GetCompressedFileSizeA(child.items, &high);
+      if (low != INVALID_FILE_SIZE || GetLastError() == NO_ERROR) *size += ((uint64_t)high << 32) | low;
+    }
+    free(child.items);
+  }
+  closedir(dir);
+  return go_on;
+}
+#else
+// Takes the directory fd. Everything is looked up relative to the directory it is in so no path gets built, and
+// symlinks are counted as themselves and not followed. st_blocks is what is allocated, so sparse files only count
+// what they really use
+bool disk_walk_dir(Disk_Walker *walker, int fd, uint64_t *size, Disk_Links *links) {
+  DIR *dir = fdopendir(fd);
+  if (!dir) {
+    close(fd);
+    return true;
+  }
+  bool go_on = true;
+  struct dirent *entry;
+  while (go_on && (entry = readdir(dir)) != NULL) {
+    if (streq(entry->d_name, ".") || streq(entry->d_name, "..")) continue;
+    go_on = disk_walker_wait(walker);
+    struct stat st;
+    if (fstatat(dirfd(dir), entry->d_name, &st, AT_SYMLINK_NOFOLLOW) < 0) continue;
+    uint64_t bytes = (uint64_t)st.st_blocks*512;
+    if (S_ISDIR(st.st_mode)) {
+      *size += bytes;
+      int child = openat(dirfd(dir), entry->d_name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+      if (child >= 0) go_on = go_on && disk_walk_dir(walker, child, size, links);
+    } else if (st.st_nlink > 1) {
+      nob_da_append(links, ((Disk_Link) { .dev = (uint64_t)st.st_dev, .ino = (uint64_t)st.st_ino, .size = bytes }));
+    } else {
+      *size += bytes;
+    }
+  }
+  closedir(dir);
+  return go_on;
+}
+#endif // _WIN32
+
+// Returns false when it was interrupted
+bool disk_measure(Disk_Walker *walker, const char *folder, uint64_t *size) {
+  *size = 0;
+  Disk_Links links = {0};
+  #ifdef _WIN32
+  Nob_String_Builder path = {0};
+  folder_path_trimmed(&path, folder);
+  bool done = disk_walk_dir(walker, path.items, size, &links);
+  free(path.items);
+  #else
+  bool done = true;
+  int fd = open(folder, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  struct stat st;
+  if (fd >= 0 && fstat(fd, &st) == 0) *size += (uint64_t)st.st_blocks*512;
+  if (fd >= 0) done = disk_walk_dir(walker, fd, size, &links);
+  #endif // _WIN32
+
+  qsort(links.items, links.count, sizeof(*links.items), compare_disk_links);
+  for (size_t i = 0; i < links.count; ++i) {
+    if (i > 0 && compare_disk_links(&links.items[i - 1], &links.items[i]) == 0) continue;
+    *size += links.items[i].size;
+  }
+  free(links.items);
+  return done;
+}
+
+// Each of the walker threads runs one of these until there are no folders left
+void disk_walk_job(void *arg) {
+  Disk_Walker *walker = arg;
+  for (;;) {
+    if (!disk_walker_wait(walker)) return;
+    mutex_lock(&walker->mutex);
+    size_t index = walker->next < walker->count ? walker->next++ : SIZE_MAX;
+    mutex_unlock(&walker->mutex);
+    if (index == SIZE_MAX) return;
+
+    Disk_Size result = { .index = index, .mtime = folder_mtime(walker->folders[index]) };
+    bool measured = false;
+    if (result.mtime != walker->known_mtimes[index]) {
+      measured = disk_measure(walker, walker->folders[index], &result.size);
+      if (!measured) return;
+    }
+
+    mutex_lock(&walker->mutex);
+    if (measured) nob_da_append(&walker->results, result);
+    walker->remaining -= 1;
+    mutex_unlock(&walker->mutex);
+  }
+}
+
+// Starts measuring every game of the catalog the library does not have an up to date size for
+bool disk_walker_start(Disk_Walker *walker, const Games *games, const Library *lib) {
+  mutex_init(&walker->mutex);
+  cond_init(&walker->resume);
+  walker->count = games->count;
+  walker->remaining = games->count;
+  walker->folders = malloc(sizeof(*walker->folders)*(games->count + 1));
+  walker->known_mtimes = malloc(sizeof(*walker->known_mtimes)*(games->count + 1));
+  NOB_ASSERT(walker->folders != NULL && walker->known_mtimes != NULL && "Buy more RAM lol");
+  for (size_t i = 0; i < games->count; ++i) {
+    walker->folders[i] = games->items[i].folder;
+    const Game_Stats *stats = &lib->stats.items[i];
+    // A size of 0 was never measured, no folder really takes nothing
+    walker->known_mtimes[i] = stats->size > 0 ? stats->size_mtime : INT64_MIN;
+  }
+  if (!worker_pool_start(&walker->pool, DISK_WALK_THREADS)) return false;
+  for (size_t i = 0; i < walker->pool.thread_count; ++i) worker_pool_submit(&walker->pool, disk_walk_job, walker);
+  return true;
+}
+
+void disk_walker_set_paused(Disk_Walker *walker, bool paused) {
+  if (walker->paused == paused) return;
+  mutex_lock(&walker->mutex);
+  walker->paused = paused;
+  if (!paused) cond_broadcast(&walker->resume);
+  mutex_unlock(&walker->mutex);
+}
+
+bool disk_walker_busy(Disk_Walker *walker) {
+  mutex_lock(&walker->mutex);
+  bool busy = walker->remaining > 0 || walker->results.count > 0;
+  mutex_unlock(&walker->mutex);
+  return busy;
+}
+
+// Hands the sizes measured so far to the library, returns how many there were
+size_t disk_walker_drain(Disk_Walker *walker, Library *lib) {
+  mutex_lock(&walker->mutex);
+  size_t count = walker->results.count;
+  for (size_t i = 0; i < count; ++i) {
+    Disk_Size *it = &walker->results.items[i];
+    library_set_size(lib, it->index, it->size, it->mtime);
+  }
+  walker->results.count = 0;
+  mutex_unlock(&walker->mutex);
+  return count;
+}
+
+void disk_walker_free(Disk_Walker *walker) {
+  mutex_lock(&walker->mutex);
+  walker->quit = true;
+  cond_broadcast(&walker->resume);
+  mutex_unlock(&walker->mutex);
+  worker_pool_stop(&walker->pool);
+  free(walker->folders);
+  free(walker->known_mtimes);
+  free(walker->results.items);
+  *walker = (Disk_Walker) {0};
+}
+
+// Binary units since that is what file managers show for sizes of folders too
+const char *format_bytes_temp(uint64_t bytes) {
+  static const char *units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+  double value = (double)bytes;
+  size_t unit = 0;
+  while (value >= 1024 && unit + 1 < NOB_ARRAY_LEN(units)) {
+    value /= 1024;
+    unit += 1;
+  }
+  if (unit == 0) return nob_temp_sprintf("%llu B", (unsigned long long)bytes);
+  return nob_temp_sprintf("%.1f %s", value, units[unit]);
+}
+
+
+#define SCROLL_WHEEL_IMPULSE 2400.0f // Pixels per second added by one notch of the wheel
+#define SCROLL_FRICTION 8.0f         // Velocity decays by e^-SCROLL_FRICTION every second
+#define SCROLL_MIN_VELOCITY 5.0f
+
+typedef struct {
+  float offset;
+  float velocity;
+} Scroll;
+
+// Returns true while the scroll is still gliding
+bool scroll_update(Scroll *scroll, float wheel, float dt, float max_offset) {
+  if (max_offset < 0) max_offset = 0;
+  scroll->velocity -= wheel*SCROLL_WHEEL_IMPULSE;
+  scroll->offset += scroll->velocity*dt;
+  scroll->velocity *= expf(-SCROLL_FRICTION*dt);
+
+  if (scroll->offset < 0) {
+    scroll->offset = 0;
+    scroll->velocity = 0;
+  } else if (scroll->offset > max_offset) {
+    scroll->offset = max_offset;
+    scroll->velocity = 0;
+  }
+  if (fabsf(scroll->velocity) < SCROLL_MIN_VELOCITY) scroll->velocity = 0;
+  return scroll->velocity != 0;
+}
+
+
+// Keyboard and gamepad selection. It follows the game and not the position so it stays on it when the grid changes
+// order, and it is only shown after a key press since the mouse has its own hover
+typedef struct {
+  bool visible;
+  // Scroll until the focused button is fully in view
+  bool reveal;
+  size_t game;
+  size_t position;
+} Focus;
+
+#define FOCUS_LINE_THICKNESS 3.0f
+
+bool nav_pressed(int key, int gamepad_button) {
+  if (IsKeyPressed(key) || IsKeyPressedRepeat(key)) return true;
+  return IsGamepadAvailable(0) && IsGamepadButtonPressed(0, gamepad_button);
+}
+
+// Looks for the focused game in a new layout, the focus goes back to the start if it is not there anymore
+void focus_sync(Focus *focus, const Layout *layout) {
+  focus->position = NAV_NONE;
+  for (size_t i = 0; i < layout->count; ++i) {
+    if (layout->items[i].game_index == focus->game) {
+      focus->position = i;
+      return;
+    }
+  }
+  if (layout->count > 0) {
+    focus->position = 0;
+    focus->game = layout->items[0].game_index;
+  }
+}
+
+// Returns true when the focus changed
+bool focus_update(Focus *focus, const Layout *layout) {
+  static const struct { int key, button; } inputs[NAV_DIRECTION_COUNT] = {
+    [NAV_UP] = { KEY_UP, GAMEPAD_BUTTON_LEFT_FACE_UP },
+    [NAV_DOWN] = { KEY_DOWN, GAMEPAD_BUTTON_LEFT_FACE_DOWN },
+    [NAV_LEFT] = { KEY_LEFT, GAMEPAD_BUTTON_LEFT_FACE_LEFT },
+    [NAV_RIGHT] = { KEY_RIGHT, GAMEPAD_BUTTON_LEFT_FACE_RIGHT },
+  };
+
+  Vector2 delta = GetMouseDelta();
+  if (focus->visible && (delta.x != 0 || delta.y != 0)) {
+    focus->visible = false;
+    return true;
+  }
+  if (layout->count == 0 || focus->position >= layout->count) return false;
+
+  for (Nav_Direction direction = 0; direction < NAV_DIRECTION_COUNT; ++direction) {
+    if (!nav_pressed(inputs[direction].key, inputs[direction].button)) continue;
+    // The first press only shows where the focus is
+    if (focus->visible) {
+      size_t to = layout->links.items[focus->position].to[direction];
+      if (to == NAV_NONE) return false;
+      focus->position = to;
+      focus->game = layout->items[to].game_index;
+    }
+    focus->visible = true;
+    focus->reveal = true;
+    return true;
+  }
+  return false;
+}
+
+GameButton *focus_activated(const Focus *focus, const Layout *layout) {
+  if (!focus->visible || focus->position >= layout->count) return NULL;
+  if (!nav_pressed(KEY_ENTER, GAMEPAD_BUTTON_RIGHT_FACE_DOWN) && !IsKeyPressed(KEY_KP_ENTER)) return NULL;
+  return &layout->items[focus->position];
+}
+
+// Smallest scroll that shows the whole focused button, padding included
+void focus_reveal(Focus *focus, const Layout *layout, Scroll *scroll, Rectangle bounds) {
+  if (!focus->reveal || focus->position >= layout->count) return;
+  focus->reveal = false;
+  const GameButton *gb = &layout->items[focus->position];
+  float top = gb->y - GENERAL_PADDING - bounds.y;
+  float bottom = gb->y + GAME_BUTTON_HEIGHT + GENERAL_PADDING - bounds.y - bounds.height;
+  if (scroll->offset > top) scroll->offset = top;
+  else if (scroll->offset < bottom) scroll->offset = bottom;
+  else return;
+  scroll->velocity = 0;
+}
+
+
+// Finds the button under a point given in layout space. Rows all have the same height so the row falls out of a
+// division and the buttons of a row are sorted by x so a binary search finds the one under the point
+GameButton *layout_hit_test(const Layout *layout, Vector2 point) {
+  if (layout->rows.count == 0) return NULL;
+  float first_y = layout->rows.items[0].y;
+  if (point.y < first_y) return NULL;
+
+  size_t r = (size_t)((point.y - first_y)/(GAME_BUTTON_HEIGHT + GENERAL_PADDING));
+  if (r >= layout->rows.count) return NULL;
+  Layout_Row row = layout->rows.items[r];
+  if (point.y >= row.y + GAME_BUTTON_HEIGHT) return NULL;
+
+  size_t lo = row.start, hi = row.start + row.count;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo)/2;
+    if (layout->items[mid].x + layout->items[mid].width <= point.x) lo = mid + 1;
+    else hi = mid;
+  }
+  if (lo >= row.start + row.count) return NULL;
+  GameButton *gb = &layout->items[lo];
+  if (point.x < gb->x) return NULL;
+  return gb;
+}
+
+Color game_button_fill_color(Button_State state) {
+  if (state & BUTTON_STATE_CLICK) return GAME_BUTTON_PICK_COLOR;
+  if (state & BUTTON_STATE_HOVER) return GAME_BUTTON_HOVR_COLOR;
+  return GAME_BUTTON_BASE_COLOR;
+}
+
+Rectangle game_button_screen_rect(const GameButton *gb, float scroll_offset) {
+  return (Rectangle) { .x = gb->x, .y = gb->y - scroll_offset, .width = gb->width, .height = GAME_BUTTON_HEIGHT };
+}
+
+void game_button_title(Font font, const GameButton *gb, float scroll_offset, bool has_art) {
+  Rectangle bounds = game_button_screen_rect(gb, scroll_offset);
+  int text_x = (int) (bounds.x + (bounds.width / 2.0 - gb->title_width / 2.0));
+  int text_y = (int)(bounds.y + bounds.height / 2.0);
+  if (has_art) text_y = (int)(bounds.y + GAME_BUTTON_ART_MARGIN*2 + ART_THUMB_SIZE);
+  Vector2 position = { (float)text_x, (float)text_y };
+  DrawTextEx(font, game_title(&gb->data), position, GAME_BUTTON_FONT_SIZE, title_spacing(font, GAME_BUTTON_FONT_SIZE), GAME_BUTTON_TEXT_COLOR);
+}
+
+// Vertices a tile sends to the batch either way. raylib draws the filled corners as quads, half as many as there
+// are segments, plus 5 quads for the middle and the sides, and the outline as lines, one per corner segment plus
+// the 4 sides. The shader tile is always one quad
+#define GAME_BUTTON_SHAPE_VERTICES (4*((GAME_BUTTON_SEGMENTS + 1)/2)*4 + 5*4 + (4*GAME_BUTTON_SEGMENTS + 4)*2)
+#define GAME_BUTTON_SHADER_VERTICES 4
+
+// Plain raylib shapes, only used when the tile shader could not be loaded
+void game_button(const GameButton *gb, float scroll_offset, Button_State state) {
+  Rectangle bounds = game_button_screen_rect(gb, scroll_offset);
+  DrawRectangleRounded(bounds, GAME_BUTTON_ROUNDNESS, GAME_BUTTON_SEGMENTS, game_button_fill_color(state));
+  DrawRectangleRoundedLines(bounds, GAME_BUTTON_ROUNDNESS, GAME_BUTTON_SEGMENTS, GAME_BUTTON_LINE_COLOR);
+}
+
+
+// Draws every tile as a single quad, the rounded corners and the border are worked out per pixel from the signed
+// distance to the rounded rectangle. The size of the tile travels in the normal so all tiles go in one batch
+static const char *tile_vertex_shader =
+  "#version 330\n"
+  "in vec3 vertexPosition;\n"
+  "in vec2 vertexTexCoord;\n"
+  "in vec3 vertexNormal;\n"
+  "in vec4 vertexColor;\n"
+  "uniform mat4 mvp;\n"
+  "out vec2 fragLocal;\n"
+  "out vec2 fragHalfSize;\n"
+  "out vec4 fragColor;\n"
+  "void main() {\n"
+  "  fragHalfSize = vertexNormal.xy*0.5;\n"
+  "  fragLocal = (vertexTexCoord - 0.5)*vertexNormal.xy;\n"
+  "  fragColor = vertexColor;\n"
+  "  gl_Position = mvp*vec4(vertexPosition, 1.0);\n"
+  "}\n";
+
+static const char *tile_fragment_shader =
+  "#version 330\n"
+  "in vec2 fragLocal;\n"
+  "in vec2 fragHalfSize;\n"
+  "in vec4 fragColor;\n"
+  "uniform float radius;\n"
+  "uniform float borderThickness;\n"
+  "uniform vec4 borderColor;\n"
+  "out vec4 finalColor;\n"
+  "void main() {\n"
+  "  vec2 q = abs(fragLocal) - fragHalfSize + radius;\n"
+  "  float d = min(max(q.x, q.y), 0.0) + length(max(q, 0.0)) - radius;\n"
+  "  float aa = max(fwidth(d), 0.0001);\n"
+  "  float shape = clamp(0.5 - d/aa, 0.0, 1.0);\n"
+  "  float border = clamp(0.5 - (abs(d + borderThickness*0.5) - borderThickness*0.5)/aa, 0.0, 1.0);\n"
+  "  vec4 color = mix(fragColor, borderColor, border);\n"
+  "  finalColor = vec4(color.rgb, color.a*shape);\n"
+  "}\n";
+
+typedef struct {
+  Shader shader;
+  bool loaded;
+} Tile_Renderer;
+
+bool tile_renderer_load(Tile_Renderer *tr) {
+  tr->shader = LoadShaderFromMemory(tile_vertex_shader, tile_fragment_shader);
+  tr->loaded = tr->shader.id != rlGetShaderIdDefault() && IsShaderValid(tr->shader);
+  if (!tr->loaded) {
+    nob_log(NOB_WARNING, "Could not load the tile shader, falling back to drawing shapes");
+    return false;
+  }
+
+  float radius = GAME_BUTTON_ROUNDNESS*GAME_BUTTON_HEIGHT/2.0f;
+  float border_thickness = 1.0f;
+  Vector4 border_color = ColorNormalize(GAME_BUTTON_LINE_COLOR);
+  SetShaderValue(tr->shader, GetShaderLocation(tr->shader, "radius"), &radius, SHADER_UNIFORM_FLOAT);
+  SetShaderValue(tr->shader, GetShaderLocation(tr->shader, "borderThickness"), &border_thickness, SHADER_UNIFORM_FLOAT);
+  SetShaderValue(tr->shader, GetShaderLocation(tr->shader, "borderColor"), &border_color, SHADER_UNIFORM_VEC4);
+  return true;
+}
+
+void tile_renderer_begin(Tile_Renderer *tr) {
+  BeginShaderMode(tr->shader);
+  rlSetTexture(rlGetTextureIdDefault());
+}
+
+void tile_renderer_push(Tile_Renderer *tr, Rectangle rect, Color fill) {
+  (void) tr;
+  rlCheckRenderBatchLimit(4);
+  rlBegin(RL_QUADS);
+    rlColor4ub(fill.r, fill.g, fill.b, fill.a);
+    rlNormal3f(rect.width, rect.height, 0.0f);
+    rlTexCoord2f(0.0f, 0.0f);
+    rlVertex2f(rect.x, rect.y);
+    rlTexCoord2f(0.0f, 1.0f);
+    rlVertex2f(rect.x, rect.y + rect.height);
+    rlTexCoord2f(1.0f, 1.0f);
+    rlVertex2f(rect.x + rect.width, rect.y + rect.height);
+    rlTexCoord2f(1.0f, 0.0f);
+    rlVertex2f(rect.x + rect.width, rect.y);
+  rlEnd();
+}
+
+void tile_renderer_end(Tile_Renderer *tr) {
+  (void) tr;
+  rlSetTexture(0);
+  rlNormal3f(0.0f, 0.0f, 1.0f);
+  EndShaderMode();
+}
+
+// Thumbnails share a few big textures so a screen full of art goes out in a handful of draw calls instead of one
+// per tile. Each page is split into shelves of similar height and thumbnails are placed left to right on them
+#define ATLAS_PAGE_SIZE 1024
+#define ATLAS_MAX_PAGES 4
+#define ATLAS_SHELF_STEP 8 // Shelf heights are rounded up to this so thumbnails of close heights share shelves
+
+typedef struct {
+  int x;
+  int width;
+} Atlas_Gap;
+
+typedef struct {
+  int y;
+  int height;
+  int cursor;
+  // Holes left behind by evicted thumbnails
+  struct {
+    Atlas_Gap *items;
+    size_t count;
+    size_t capacity;
+  } gaps;
+} Atlas_Shelf;
+
+typedef struct {
+  Texture2D texture;
+  struct {
+    Atlas_Shelf *items;
+    size_t count;
+    size_t capacity;
+  } shelves;
+  int shelves_bottom;
+} Atlas_Page;
+
+typedef struct {
+  Atlas_Page pages[ATLAS_MAX_PAGES];
+  size_t page_count;
+} Atlas;
+
+typedef struct {
+  int page;
+  int shelf;
+  Rectangle rect;
+  // Can be a bit wider than rect when it took over a hole that was not worth splitting
+  int reserved_width;
+} Atlas_Slot;
+
+bool atlas_page_alloc(Atlas_Page *page, int width, int height, Atlas_Slot *slot) {
+  int shelf_height = (height + ATLAS_SHELF_STEP - 1)/ATLAS_SHELF_STEP*ATLAS_SHELF_STEP;
+  for (size_t i = 0; i < page->shelves.count; ++i) {
+    Atlas_Shelf *shelf = &page->shelves.items[i];
+    if (shelf->height != shelf_height) continue;
+
+    for (size_t g = 0; g < shelf->gaps.count; ++g) {
+      Atlas_Gap gap = shelf->gaps.items[g];
+      if (gap.width < width) continue;
+      slot->shelf = (int)i;
+      slot->rect = (Rectangle) { gap.x, shelf->y, width, height };
+      slot->reserved_width = width;
+      if (gap.width - width >= ATLAS_SHELF_STEP) {
+        shelf->gaps.items[g] = (Atlas_Gap) { .x = gap.x + width, .width = gap.width - width };
+      } else {
+        nob_da_remove_unordered(&shelf->gaps, g);
+        slot->reserved_width = gap.width;
+      }
+      return true;
+    }
+
+    if (shelf->cursor + width <= ATLAS_PAGE_SIZE) {
+      slot->shelf = (int)i;
+      slot->rect = (Rectangle) { shelf->cursor, shelf->y, width, height };
+      slot->reserved_width = width;
+      shelf->cursor += width;
+      return true;
+    }
+  }
+
+  if (page->shelves_bottom + shelf_height > ATLAS_PAGE_SIZE) return false;
+  Atlas_Shelf shelf = { .y = page->shelves_bottom, .height = shelf_height, .cursor = width };
+  nob_da_append(&page->shelves, shelf);
+  page->shelves_bottom += shelf_height;
+  slot->shelf = (int)page->shelves.count - 1;
+  slot->rect = (Rectangle) { 0, shelf.y, width, height };
+  slot->reserved_width = width;
+  return true;
+}
+
+bool atlas_alloc(Atlas *atlas, int width, int height, Atlas_Slot *slot) {
+  for (size_t p = 0; p < atlas->page_count; ++p) {
+    if (atlas_page_alloc(&atlas->pages[p], width, height, slot)) {
+      slot->page = (int)p;
+      return true;
+    }
+  }
+
+  if (atlas->page_count >= ATLAS_MAX_PAGES) return false;
+  Atlas_Page *page = &atlas->pages[atlas->page_count];
+  Image blank = GenImageColor(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, BLANK);
+  *page = (Atlas_Page) { .texture = LoadTextureFromImage(blank) };
+  UnloadImage(blank);
+  if (!IsTextureValid(page->texture)) {
+    nob_log(NOB_ERROR, "Could not create a texture for the art atlas");
+    return false;
+  }
+  atlas->page_count += 1;
+  if (!atlas_page_alloc(page, width, height, slot)) return false;
+  slot->page = (int)atlas->page_count - 1;
+  return true;
+}
+
+void atlas_release(Atlas *atlas, Atlas_Slot slot) {
+  Atlas_Shelf *shelf = &atlas->pages[slot.page].shelves.items[slot.shelf];
+  int x = (int)slot.rect.x;
+  int width = slot.reserved_width;
+  if (x + width == shelf->cursor) shelf->cursor = x;
+  else nob_da_append(&shelf->gaps, ((Atlas_Gap) { .x = x, .width = width }));
+}
+
+// Forgets where everything was placed in a page so it can be filled again from scratch
+void atlas_page_reset(Atlas_Page *page) {
+  nob_da_foreach(Atlas_Shelf, shelf, &page->shelves) free(shelf->gaps.items);
+  page->shelves.count = 0;
+  page->shelves_bottom = 0;
+}
+
+void atlas_free(Atlas *atlas) {
+  for (size_t p = 0; p < atlas->page_count; ++p) {
+    atlas_page_reset(&atlas->pages[p]);
+    free(atlas->pages[p].shelves.items);
+    UnloadTexture(atlas->pages[p].texture);
+  }
+  atlas->page_count = 0;
+}
+
+#define ART_WORKERS 4
+#define ART_UPLOADS_PER_FRAME 8
+#define ART_UPLOAD_BUDGET_NS (2*1000*1000)
+#define ART_MAX_RESIDENT 256         // Thumbnails kept in the atlas before the least recently seen start being dropped
+#define ART_PREFETCH_ROWS 2          // Rows above and below the viewport whose art is requested ahead of time
+#define ART_EVICT_DISTANCE_ROWS 8    // Textures this close to the viewport are never dropped
+#define ART_NIL ((size_t)-1)
+
+typedef enum {
+  ART_NONE = 0,
+  ART_QUEUED,
+  ART_READY,
+  ART_MISSING,
+} Art_State;
+
+typedef struct {
+  Art_State state;
+  Atlas_Slot atlas;
+  // Copy of the pixels kept on the CPU so the atlas can be repacked without going back to the disk
+  Image pixels;
+  // Where the tile was last seen, in layout space, to know how far it is from the viewport
+  float y;
+  // Slots holding a texture form a list from the most to the least recently seen
+  size_t lru_prev, lru_next;
+} Art_Slot;
+
+typedef struct {
+  size_t index;
+  Image image;
+  // When set the pixels of image live in here instead of the heap
+  Mapped_File mapped;
+} Art_Result;
+
+typedef List(Art_Result) Art_Results;
+
+// Artwork of every game, indexed like the catalog. Decoding happens on the workers and only the upload to the GPU
+// happens on the main thread
+typedef struct {
+  Art_Slot *items;
+  size_t count;
+  size_t capacity;
+  Worker_Pool pool;
+  Mutex results_mutex;
+  Art_Results results;
+  // Jobs submitted whose result was not consumed yet, only touched by the main thread
+  size_t in_flight;
+  size_t lru_head, lru_tail;
+  size_t resident;
+  Atlas atlas;
+  // Where the thumbnails are kept between runs, NULL when there is no place for them
+  const char *thumbs_dir;
+  // The first screen of art is taken straight from the thumbnail cache instead of waiting for the workers
+  bool warm_start;
+} Art_Cache;
+
+typedef struct {
+  Art_Cache *art;
+  size_t index;
+  const char *folder;
+} Art_Job;
+
+bool art_try_candidate(Nob_String_Builder *path, const char *folder, const char *file) {
+  path->count = 0;
+  if (file[0] == '/') {
+    nob_sb_append_cstr(path, file);
+  } else {
+    nob_sb_append_cstr(path, folder);
+    nob_sb_append_cstr(path, file);
+  }
+  nob_sb_append_null(path);
+
+  Nob_String_View sv = nob_sv_from_cstr(path->items);
+  if (!nob_sv_end_with(sv, ".png") && !nob_sv_end_with(sv, ".jpg") && !nob_sv_end_with(sv, ".jpeg")) return false;
+  return nob_file_exists(path->items) == 1;
+}
+
+// Looks for the Icon= entry of a .desktop file, only icons that resolve to an actual image file are of any use
+bool art_try_desktop_entry(Nob_String_Builder *path, const char *folder, const char *desktop_file) {
+  Nob_String_Builder content = {0};
+  bool found = false;
+  path->count = 0;
+  nob_sb_append_cstr(path, folder);
+  nob_sb_append_cstr(path, desktop_file);
+  nob_sb_append_null(path);
+  if (!nob_read_entire_file(path->items, &content)) return false;
+
+  Nob_String_View sv = nob_sv_from_parts(content.items, content.count);
+  while (sv.count > 0 && !found) {
+    Nob_String_View line = nob_sv_trim(nob_sv_chop_by_delim(&sv, '\n'));
+    if (!nob_sv_starts_with(line, nob_sv_from_cstr("Icon="))) continue;
+    nob_sv_chop_left(&line, 5);
+    Nob_String_Builder icon = {0};
+    nob_sb_append_buf(&icon, line.data, line.count);
+    nob_sb_append_null(&icon);
+    found = art_try_candidate(path, folder, icon.items);
+    if (!found) {
+      // Icons are usually named without extension
+      icon.count -= 1;
+      nob_sb_append_cstr(&icon, ".png");
+      nob_sb_append_null(&icon);
+      found = art_try_candidate(path, folder, icon.items);
+    }
+    free(icon.items);
+  }
+
+  free(content.items);
+  return found;
+}
+
+// Runs on the workers so it must stay away from the temporary storage of nob
+bool art_find(const char *folder, Nob_String_Builder *path) {
+  static const char *well_known[] = { "icon.png", "cover.jpg", "cover.png", "icon.jpg" };
+  for (size_t i = 0; i < NOB_ARRAY_LEN(well_known); ++i) {
+    if (art_try_candidate(path, folder, well_known[i])) return true;
+  }
+
+  DIR *dir = opendir(folder);
+  if (!dir) return false;
+  bool found = false;
+  Nob_String_Builder file = {0};
+  for (struct dirent *ent = readdir(dir); ent && !found; ent = readdir(dir)) {
+    Nob_String_View name = nob_sv_from_cstr(ent->d_name);
+    if (nob_sv_end_with(name, ".desktop")) {
+      found = art_try_desktop_entry(path, folder, ent->d_name);
+    } else if (nob_sv_end_with(name, "_Data")) {
+      // Unity builds keep the icon of the game in <Name>_Data/Resources
+      file.count = 0;
+      nob_sb_appendf(&file, "%s%cResources%cUnityPlayer.png", ent->d_name, PATH_DELIM, PATH_DELIM);
+      found = art_try_candidate(path, folder, file.items);
+    } else if (nob_sv_end_with(name, ".pck")) {
+      // Godot exports ship the icon next to the .pck when it was exported with one
+      file.count = 0;
+      nob_sb_appendf(&file, "%.*s.png", (int)(name.count - 4), name.data);
+      found = art_try_candidate(path, folder, file.items);
+    }
+  }
+  free(file.items);
+  closedir(dir);
+  return found;
+}
+
+void art_fit_thumbnail(Image *image) {
+  ImageFormat(image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+  if (image->width <= ART_THUMB_SIZE && image->height <= ART_THUMB_SIZE) return;
+  float scale = (float)ART_THUMB_SIZE/MAX(image->width, image->height);
+  int width = MAX(1, (int)(image->width*scale));
+  int height = MAX(1, (int)(image->height*scale));
+  ImageResize(image, width, height);
+}
+
+void art_result_release(Art_Result *result) {
+  if (result->mapped.data) unmap_file(&result->mapped);
+  else if (result->image.data) UnloadImage(result->image);
+  result->image = (Image) {0};
+}
+
+
+// Thumbnails already scaled to ART_THUMB_SIZE are kept on disk as raw RGBA so a later run can map them and hand
+// them to the GPU without decoding anything
+#define THUMB_MAGIC 0x48545a4c // "LZTH"
+#define THUMB_VERSION 1
+#define THUMB_CACHE_CAP (64*1024*1024)
+#define THUMB_SUFFIX ".thumb"
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t width;
+  uint32_t height;
+} Thumb_Header;
+
+// Name of the thumbnail of a source image, changes whenever the source is touched or the thumbnails change size
+bool thumb_cache_path(const char *thumbs_dir, const char *source, Nob_String_Builder *out) {
+  struct stat st;
+  if (stat(source, &st) < 0) return false;
+  uint64_t key = hash_cstr(source);
+  key = (key ^ (uint64_t)st.st_mtime)*1099511628211ULL;
+  key = (key ^ (uint64_t)ART_THUMB_SIZE)*1099511628211ULL;
+  out->count = 0;
+  nob_sb_appendf(out, "%s%c%016llx"THUMB_SUFFIX, thumbs_dir, PATH_DELIM, (unsigned long long)key);
+  nob_sb_append_null(out);
+  return true;
+}
+
+bool thumb_cache_load(const char *thumb_path, Art_Result *result) {
+  Mapped_File mf = {0};
+  if (!map_file(thumb_path, &mf)) return false;
+  Thumb_Header header = {0};
+  if (mf.size >= sizeof(header)) memcpy(&header, mf.data, sizeof(header));
+  bool valid = header.magic == THUMB_MAGIC && header.version == THUMB_VERSION
+    && header.width > 0 && header.width <= ART_THUMB_SIZE
+    && header.height > 0 && header.height <= ART_THUMB_SIZE
+    && mf.size == sizeof(header) + (size_t)header.width*header.height*4;
+  if (!valid) {
+    unmap_file(&mf);
+    return false;
+  }
+
+  // Touching the thumbnail is what keeps it at the young end of the LRU
+  utime(thumb_path, NULL);
+  result->mapped = mf;
+  result->image = (Image) {
+    .data = (char*)mf.data + sizeof(header),
+    .width = header.width,
+    .height = header.height,
+    .mipmaps = 1,
+    .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
+  };
+  return true;
+}
+
+void thumb_cache_store(const char *thumb_path, Image image, size_t unique) {
+  Thumb_Header header = { .magic = THUMB_MAGIC, .version = THUMB_VERSION, .width = image.width, .height = image.height };
+  Nob_String_Builder sb = {0};
+  nob_sb_append_buf(&sb, (const char *)&header, sizeof(header));
+  nob_sb_append_buf(&sb, (const char *)image.data, (size_t)image.width*image.height*4);
+
+  // Written under another name first so a reader never maps a half written thumbnail
+  Nob_String_Builder tmp = {0};
+  nob_sb_appendf(&tmp, "%s.%zu.tmp", thumb_path, unique);
+  nob_sb_append_null(&tmp);
+  if (nob_write_entire_file(tmp.items, sb.items, sb.count)) {
+    if (rename(tmp.items, thumb_path) < 0) remove(tmp.items);
+  }
+  free(tmp.items);
+  free(sb.items);
+}
+
+typedef struct {
+  char *path;
+  time_t mtime;
+  size_t size;
+} Thumb_File;
+
+typedef List(Thumb_File) Thumb_Files;
+
+int thumb_file_compare_mtime(const void *a, const void *b) {
+  time_t ma = ((const Thumb_File*)a)->mtime;
+  time_t mb = ((const Thumb_File*)b)->mtime;
+  return (ma > mb) - (ma < mb);
+}
+
+// Drops the least recently used thumbnails until the cache fits in THUMB_CACHE_CAP
+void thumb_cache_trim_job(void *arg) {
+  const char *thumbs_dir = arg;
+  DIR *dir = opendir(thumbs_dir);
+  if (!dir) return;
+
+  Thumb_Files files = {0};
+  size_t total = 0;
+  for (struct dirent *ent = readdir(dir); ent; ent = readdir(dir)) {
+    if (!nob_sv_end_with(nob_sv_from_cstr(ent->d_name), THUMB_SUFFIX)) continue;
+    Nob_String_Builder path = {0};
+    nob_sb_appendf(&path, "%s%c%s", thumbs_dir, PATH_DELIM, ent->d_name);
+    nob_sb_append_null(&path);
+    struct stat st;
+    if (stat(path.items, &st) < 0) {
+      free(path.items);
+      continue;
+    }
+    nob_da_append(&files, ((Thumb_File) { .path = path.items, .mtime = st.st_mtime, .size = st.st_size }));
+    total += st.st_size;
+  }
+  closedir(dir);
+
+  if (total > THUMB_CACHE_CAP) {
+    qsort(files.items, files.count, sizeof(*files.items), thumb_file_compare_mtime);
+    for (size_t i = 0; i < files.count && total > THUMB_CACHE_CAP; ++i) {
+      if (remove(files.items[i].path) == 0) total -= files.items[i].size;
+    }
+  }
+
+  nob_da_foreach(Thumb_File, it, &files) free(it->path);
+  free(files.items);
+}
+
+// Looks for the art of a game and tries the thumbnail cache before decoding it
+bool art_load(const char *thumbs_dir, const char *folder, size_t unique, Art_Result *art_result) {
+  Nob_String_Builder path = {0};
+  Nob_String_Builder thumb = {0};
+  Nob_String_Builder data = {0};
+  bool result = false;
+
+  if (!art_find(folder, &path)) nob_return_defer(false);
+  bool cacheable = thumbs_dir && thumb_cache_path(thumbs_dir, path.items, &thumb);
+  if (cacheable && thumb_cache_load(thumb.items, art_result)) nob_return_defer(true);
+
+  if (!nob_read_entire_file(path.items, &data)) nob_return_defer(false);
+  const char *ext = strrchr(path.items, '.');
+  art_result->image = LoadImageFromMemory(ext, (const unsigned char *)data.items, (int)data.count);
+  if (!art_result->image.data) nob_return_defer(false);
+  art_fit_thumbnail(&art_result->image);
+  if (cacheable) thumb_cache_store(thumb.items, art_result->image, unique);
+  result = true;
+
+defer:
+  free(path.items);
+  free(thumb.items);
+  free(data.items);
+  return result;
+}
+
+void art_load_job(void *arg) {
+  Art_Job *job = arg;
+  Art_Cache *art = job->art;
+  Art_Result result = { .index = job->index };
+  art_load(art->thumbs_dir, job->folder, job->index, &result);
+
+  mutex_lock(&art->results_mutex);
+  nob_da_append(&art->results, result);
+  mutex_unlock(&art->results_mutex);
+  free(job);
+}
+
+bool art_init(Art_Cache *art, const char *cache_dir) {
+  art->lru_head = art->lru_tail = ART_NIL;
+  art->thumbs_dir = cache_dir;
+  art->warm_start = cache_dir != NULL;
+  mutex_init(&art->results_mutex);
+  if (!worker_pool_start(&art->pool, MIN(ART_WORKERS, (size_t)nob_nprocs()))) return false;
+  if (cache_dir) worker_pool_submit(&art->pool, thumb_cache_trim_job, (void*)cache_dir);
+  return true;
+}
+
+// Keeps one slot per game, the catalog only ever grows
+void art_sync_catalog(Art_Cache *art, size_t games_count) {
+  size_t old_count = art->count;
+  if (games_count <= old_count) return;
+  nob_da_resize(art, games_count);
+  memset(art->items + old_count, 0, sizeof(Art_Slot)*(games_count - old_count));
+}
+
+void art_lru_unlink(Art_Cache *art, size_t index) {
+  Art_Slot *slot = &art->items[index];
+  if (slot->lru_prev != ART_NIL) art->items[slot->lru_prev].lru_next = slot->lru_next;
+  else art->lru_head = slot->lru_next;
+  if (slot->lru_next != ART_NIL) art->items[slot->lru_next].lru_prev = slot->lru_prev;
+  else art->lru_tail = slot->lru_prev;
+  slot->lru_prev = slot->lru_next = ART_NIL;
+}
+
+void art_lru_push_front(Art_Cache *art, size_t index) {
+  Art_Slot *slot = &art->items[index];
+  slot->lru_prev = ART_NIL;
+  slot->lru_next = art->lru_head;
+  if (art->lru_head != ART_NIL) art->items[art->lru_head].lru_prev = index;
+  art->lru_head = index;
+  if (art->lru_tail == ART_NIL) art->lru_tail = index;
+}
+
+// Asks for the art of the tiles in the given range and marks the ones already on the GPU as recently seen
+void art_request(Art_Cache *art, const GameButton *begin, const GameButton *end) {
+  for (const GameButton *gb = begin; gb < end; ++gb) {
+    Art_Slot *slot = &art->items[gb->game_index];
+    slot->y = gb->y;
+    if (slot->state == ART_READY) {
+      art_lru_unlink(art, gb->game_index);
+      art_lru_push_front(art, gb->game_index);
+    } else if (slot->state == ART_NONE) {
+      Art_Job *job = malloc(sizeof(*job));
+      NOB_ASSERT(job != NULL && "Buy more RAM lol");
+      *job = (Art_Job) { .art = art, .index = gb->game_index, .folder = gb->data.folder };
+      slot->state = ART_QUEUED;
+      art->in_flight += 1;
+      worker_pool_submit(&art->pool, art_load_job, job);
+    }
+  }
+}
+
+bool art_has_results(Art_Cache *art) {
+  mutex_lock(&art->results_mutex);
+  bool any = art->results.count > 0;
+  mutex_unlock(&art->results_mutex);
+  return any;
+}
+
+void art_drop(Art_Cache *art, size_t index) {
+  Art_Slot *slot = &art->items[index];
+  art_lru_unlink(art, index);
+  atlas_release(&art->atlas, slot->atlas);
+  UnloadImage(slot->pixels);
+  slot->pixels = (Image) {0};
+  slot->state = ART_NONE;
+  art->resident -= 1;
+}
+
+// The tiles moved somewhere else. Where the ones still shown ended up is set again when they are requested, the rest
+// are out of the view and can go whenever
+void art_forget_positions(Art_Cache *art) {
+  for (size_t index = art->lru_head; index != ART_NIL; index = art->items[index].lru_next) {
+    art->items[index].y = -INFINITY;
+  }
+}
+
+// Drops the art of the least recently seen tiles as long as they are far enough from what is on screen
+void art_evict(Art_Cache *art, float view_top, float view_bottom) {
+  float margin = ART_EVICT_DISTANCE_ROWS*(GAME_BUTTON_HEIGHT + GENERAL_PADDING);
+  while (art->resident > ART_MAX_RESIDENT && art->lru_tail != ART_NIL) {
+    size_t index = art->lru_tail;
+    Art_Slot *slot = &art->items[index];
+    if (slot->y + GAME_BUTTON_HEIGHT >= view_top - margin && slot->y <= view_bottom + margin) break;
+    art_drop(art, index);
+  }
+}
+
+// Places the thumbnails of a page again from scratch, gets rid of the holes evictions leave behind
+void art_repack_page(Art_Cache *art, int page) {
+  atlas_page_reset(&art->atlas.pages[page]);
+  size_t next = ART_NIL;
+  for (size_t index = art->lru_head; index != ART_NIL; index = next) {
+    next = art->items[index].lru_next;
+    Art_Slot *slot = &art->items[index];
+    if (slot->atlas.page != page) continue;
+    if (!atlas_page_alloc(&art->atlas.pages[page], slot->pixels.width, slot->pixels.height, &slot->atlas)) {
+      // Can't really happen since everything fitted before, but if it does the tile just loads again later
+      art_lru_unlink(art, index);
+      UnloadImage(slot->pixels);
+      slot->pixels = (Image) {0};
+      slot->state = ART_NONE;
+      art->resident -= 1;
+      continue;
+    }
+    slot->atlas.page = page;
+    UpdateTextureRec(art->atlas.pages[page].texture, slot->atlas.rect, slot->pixels.data);
+  }
+}
+
+bool art_place(Art_Cache *art, int width, int height, Atlas_Slot *out) {
+  if (atlas_alloc(&art->atlas, width, height, out)) return true;
+  for (size_t page = 0; page < art->atlas.page_count; ++page) {
+    art_repack_page(art, (int)page);
+    if (atlas_page_alloc(&art->atlas.pages[page], width, height, out)) {
+      out->page = (int)page;
+      return true;
+    }
+  }
+  // Every page is packed tight, make room by dropping whatever was seen the longest time ago
+  while (art->lru_tail != ART_NIL) {
+    int page = art->items[art->lru_tail].atlas.page;
+    art_drop(art, art->lru_tail);
+    art_repack_page(art, page);
+    if (atlas_page_alloc(&art->atlas.pages[page], width, height, out)) {
+      out->page = page;
+      return true;
+    }
+  }
+  return false;
+}
+
+void art_store_result(Art_Cache *art, Art_Result *result) {
+  Art_Slot *slot = &art->items[result->index];
+  if (!result->image.data) {
+    slot->state = ART_MISSING;
+    return;
+  }
+
+  if (result->mapped.data) {
+    slot->pixels = ImageCopy(result->image);
+    art_result_release(result);
+  } else {
+    slot->pixels = result->image;
+    result->image = (Image) {0};
+  }
+
+  if (!art_place(art, slot->pixels.width, slot->pixels.height, &slot->atlas)) {
+    nob_log(NOB_WARNING, "No room left in the art atlas");
+    UnloadImage(slot->pixels);
+    slot->pixels = (Image) {0};
+    slot->state = ART_MISSING;
+    return;
+  }
+  UpdateTextureRec(art->atlas.pages[slot->atlas.page].texture, slot->atlas.rect, slot->pixels.data);
+  slot->state = ART_READY;
+  art_lru_push_front(art, result->index);
+  art->resident += 1;
+}
+
+// The very first screen only takes what is already in the thumbnail cache, synchronously, so a warm start shows
+// its art on the first frame. Anything missing there is left to the workers as usual
+void art_warm_start(Art_Cache *art, const GameButton *begin, const GameButton *end) {
+  if (!art->warm_start || begin == end) return;
+  art->warm_start = false;
+
+  Nob_String_Builder path = {0};
+  Nob_String_Builder thumb = {0};
+  for (const GameButton *gb = begin; gb < end; ++gb) {
+    Art_Slot *slot = &art->items[gb->game_index];
+    if (slot->state != ART_NONE) continue;
+    if (!art_find(gb->data.folder, &path)) continue;
+    if (!thumb_cache_path(art->thumbs_dir, path.items, &thumb)) continue;
+    Art_Result result = { .index = gb->game_index };
+    if (!thumb_cache_load(thumb.items, &result)) continue;
+    slot->y = gb->y;
+    art_store_result(art, &result);
+  }
+  free(path.items);
+  free(thumb.items);
+}
+
+// Uploads what the workers decoded, bounded by count and by time so a burst of results can't cause a hitch.
+// Returns true when there is still something left to upload
+bool art_upload(Art_Cache *art) {
+  uint64_t started = nob_nanos_since_unspecified_epoch();
+  for (size_t uploaded = 0; uploaded < ART_UPLOADS_PER_FRAME; ++uploaded) {
+    if (nob_nanos_since_unspecified_epoch() - started > ART_UPLOAD_BUDGET_NS) break;
+
+    Art_Result result = {0};
+    mutex_lock(&art->results_mutex);
+    bool got = art->results.count > 0;
+    if (got) result = art->results.items[--art->results.count];
+    mutex_unlock(&art->results_mutex);
+    if (!got) break;
+
+    art->in_flight -= 1;
+    art_store_result(art, &result);
+  }
+  return art_has_results(art);
+}
+
+bool art_ready(const Art_Cache *art, const GameButton *gb) {
+  return art->items[gb->game_index].state == ART_READY;
+}
+
+void art_draw(const Art_Cache *art, const GameButton *gb, float scroll_offset) {
+  const Art_Slot *slot = &art->items[gb->game_index];
+  if (slot->state != ART_READY) return;
+  Rectangle bounds = game_button_screen_rect(gb, scroll_offset);
+  Vector2 position = {
+    .x = floorf(bounds.x + (bounds.width - slot->atlas.rect.width)/2.0f),
+    .y = floorf(bounds.y + GAME_BUTTON_ART_MARGIN + (ART_THUMB_SIZE - slot->atlas.rect.height)/2.0f),
+  };
+  DrawTextureRec(art->atlas.pages[slot->atlas.page].texture, slot->atlas.rect, position, WHITE);
+}
+
+void art_free(Art_Cache *art) {
+  worker_pool_stop(&art->pool);
+  nob_da_foreach(Art_Slot, slot, art) {
+    if (slot->state == ART_READY) UnloadImage(slot->pixels);
+  }
+  atlas_free(&art->atlas);
+  nob_da_foreach(Art_Result, it, &art->results) art_result_release(it);
+  free(art->results.items);
+  free(art->items);
+  *art = (Art_Cache) {0};
+}
+
+// All the tiles first, then the art and then the titles so no pass has to switch shaders in between
+void draw_game_buttons(Tile_Renderer *tiles, const Art_Cache *art, Font font, GameButton *begin, GameButton *end,
+                       float scroll_offset, const GameButton *hovered, Button_State hovered_state) {
+  if (tiles->loaded) {
+    tile_renderer_begin(tiles);
+    for (GameButton *gb = begin; gb < end; ++gb) {
+      Button_State state = gb == hovered ? hovered_state : BUTTON_STATE_NONE;
+      tile_renderer_push(tiles, game_button_screen_rect(gb, scroll_offset), game_button_fill_color(state));
+    }
+    tile_renderer_end(tiles);
+  } else {
+    for (GameButton *gb = begin; gb < end; ++gb) {
+      game_button(gb, scroll_offset, gb == hovered ? hovered_state : BUTTON_STATE_NONE);
+    }
+  }
+  for (GameButton *gb = begin; gb < end; ++gb) {
+    art_draw(art, gb, scroll_offset);
+  }
+  for (GameButton *gb = begin; gb < end; ++gb) {
+    game_button_title(font, gb, scroll_offset, art_ready(art, gb));
+  }
+}
+
+#define TOOLTIP_FONT_SIZE 16
+
+// Title of the game and what the library knows about it, next to the mouse but never out of the window. The details
+// use the default font since the UI font only has the glyphs of the titles
+void draw_game_tooltip(Font font, const GameButton *gb, const Game_Stats *stats, Vector2 mouse) {
+  size_t save = nob_temp_save();
+  const char *title = game_title(&gb->data);
+  const char *lines[2] = {0};
+  size_t line_count = 0;
+  lines[line_count++] = stats->size > 0
+    ? nob_temp_sprintf("%s on disk", format_bytes_temp(stats->size))
+    : "Measuring size...";
+  if (stats->playtime > 0) {
+    lines[line_count++] = nob_temp_sprintf("%lldh %02lldm played",
+                                           (long long)(stats->playtime/3600), (long long)(stats->playtime/60%60));
+  }
+
+  float spacing = title_spacing(font, GAME_BUTTON_FONT_SIZE);
+  Vector2 title_size = MeasureTextEx(font, title, GAME_BUTTON_FONT_SIZE, spacing);
+  float width = title_size.x;
+  for (size_t i = 0; i < line_count; ++i) width = MAX(width, MeasureText(lines[i], TOOLTIP_FONT_SIZE));
+  Rectangle box = {
+    .x = mouse.x + 16, .y = mouse.y + 16,
+    .width = width + GENERAL_PADDING*2,
+    .height = title_size.y + line_count*(TOOLTIP_FONT_SIZE + 4) + GENERAL_PADDING*2,
+  };
+  if (box.x + box.width > GetScreenWidth()) box.x = MAX(0, mouse.x - box.width - 4);
+  if (box.y + box.height > GetScreenHeight()) box.y = MAX(0, mouse.y - box.height - 4);
+
+  DrawRectangleRec(box, RGB(30, 30, 30));
+  DrawRectangleLinesEx(box, 1, GAME_BUTTON_LINE_COLOR);
+  float y = box.y + GENERAL_PADDING;
+  DrawTextEx(font, title, (Vector2) { box.x + GENERAL_PADDING, y }, GAME_BUTTON_FONT_SIZE, spacing, GAME_BUTTON_TEXT_COLOR);
+  y += title_size.y + 4;
+  for (size_t i = 0; i < line_count; ++i) {
+    DrawText(lines[i], (int)(box.x + GENERAL_PADDING), (int)y, TOOLTIP_FONT_SIZE, GAME_BUTTON_LINE_COLOR);
+    y += TOOLTIP_FONT_SIZE + 4;
+  }
+  nob_temp_rewind(save);
+}
+
+// The sort mode goes in the title, there is nowhere else in the window that is always visible
+void set_window_title(Sort_Mode sort) {
+  size_t save = nob_temp_save();
+  SetWindowTitle(nob_temp_sprintf("Lzua - by %s", sort_mode_names[sort]));
+  nob_temp_rewind(save);
+}
+
+bool launch_game(Nob_Cmd *cmd, Nob_Procs *processes, const Game *game) {
+  size_t save = nob_temp_save();
+  #ifdef _WIN32
+  const char *game_cmd = nob_temp_sprintf("%s%c%s", game->folder, PATH_DELIM, game->exe);
+  #else
+  const char *game_cmd = nob_temp_sprintf(".%c%s", PATH_DELIM, game->exe);
+  #endif // _WIN32
+  nob_cmd_append(cmd, game_cmd);
+  bool ok = nob_cmd_run(cmd, .async = processes, .cwd_path = game->folder);
+  if (!ok) {
+    nob_log(NOB_ERROR, "Failed to fork process to open game: %s", game->name);
+  } else {
+    nob_log(NOB_INFO, "Launched: %s", game->name);
+  }
+  nob_temp_rewind(save);
+  return ok;
+}
+
+// One game at a time, its playtime counts from here until the process exits
+bool play_game(Nob_Cmd *cmd, Nob_Procs *processes, Library *library, const Games *games, size_t index,
+               size_t *running_game, int64_t *running_since) {
+  if (processes->count > 0) {
+    nob_log(NOB_WARNING, "A game is already running, not launching %s", games->items[index].name);
+    return false;
+  }
+  if (!launch_game(cmd, processes, &games->items[index])) return false;
+  *running_game = index;
+  *running_since = (int64_t)time(NULL);
+  library_record_launch(library, index, *running_since);
+  return true;
+}
+
+typedef enum {
+  PROC_RUNNING,
+  PROC_EXITED,
+  PROC_FAILED,
+} Proc_Status;
+
+// Same as nob_proc_wait but returns right away if the process is still running
+Proc_Status proc_poll(Nob_Proc proc) {
+  #ifdef _WIN32
+  DWORD result = WaitForSingleObject(proc, 0);
+  if (result == WAIT_TIMEOUT) return PROC_RUNNING;
+  if (result == WAIT_FAILED) {
+    nob_log(NOB_ERROR, "could not wait on child process: %s", nob_win32_error_message(GetLastError()));
+    return PROC_FAILED;
+  }
+
+  DWORD exit_status;
+  bool got_status = GetExitCodeProcess(proc, &exit_status);
+  CloseHandle(proc);
+  if (!got_status) {
+    nob_log(NOB_ERROR, "could not get process exit code: %s", nob_win32_error_message(GetLastError()));
+    return PROC_FAILED;
+  }
+  if (exit_status != 0) {
+    nob_log(NOB_ERROR, "command exited with exit code %lu", exit_status);
+    return PROC_FAILED;
+  }
+  return PROC_EXITED;
+  #else
+  int wstatus = 0;
+  pid_t pid = waitpid(proc, &wstatus, WNOHANG);
+  if (pid == 0) return PROC_RUNNING;
+  if (pid < 0) {
+    nob_log(NOB_ERROR, "could not wait on command (pid %d): %s", proc, strerror(errno));
+    return PROC_FAILED;
+  }
+  if (WIFEXITED(wstatus) && WEXITSTATUS(wstatus) != 0) {
+    nob_log(NOB_ERROR, "command exited with exit code %d", WEXITSTATUS(wstatus));
+    return PROC_FAILED;
+  }
+  if (WIFSIGNALED(wstatus)) {
+    nob_log(NOB_ERROR, "command process was terminated by signal %d", WTERMSIG(wstatus));
+    return PROC_FAILED;
+  }
+  return PROC_EXITED;
+  #endif // _WIN32
+}
+
+
+// Resident mode keeps the first lzua around with its window hidden so the next launch only has to show it again.
+// Later invocations talk to it over a unix socket with one line per connection: "show", "launch <title>" or "quit",
+// and it answers "ok" or an error
+#define RESIDENT_SOCKET_FILE "lzua.sock"
+#define RESIDENT_LINE_MAX 1024
+#define RESIDENT_WAIT_FOREVER UINT32_MAX
+// How often a hidden launcher still looks after the running game and the background work
+#define RESIDENT_HIDDEN_POLL_MS 250
+
+typedef enum {
+  RESIDENT_SHOW,
+  RESIDENT_LAUNCH,
+  RESIDENT_QUIT,
+} Resident_Command;
+
+typedef struct {
+  Resident_Command command;
+  // Title of the game for RESIDENT_LAUNCH, owned by the request
+  char *name;
+} Resident_Request;
+
+typedef struct {
+  // Requests come from the listener thread and from the command line of the first instance alike
+  List(Resident_Request) requests;
+  Mutex mutex;
+  Cond cond;
+  Thread thread;
+  bool listening;
+  bool hidden;
+  int fd;
+  char *path;
+} Resident;
+
+// Where the socket goes, the runtime directory is private to the user and cleared on logout
+char *resident_socket_path(const char *cache_dir) {
+  const char *env = getenv("XDG_RUNTIME_DIR");
+  if (env && env[0] == '/') return strdup(nob_temp_sprintf("%s%c%s", env, PATH_DELIM, RESIDENT_SOCKET_FILE));
+  if (cache_dir) return strdup(nob_temp_sprintf("%s%c%s", cache_dir, PATH_DELIM, RESIDENT_SOCKET_FILE));
+  return NULL;
+}
+
+void resident_init(Resident *resident) {
+  mutex_init(&resident->mutex);
+  cond_init(&resident->cond);
+  resident->fd = -1;
+}
+
+void resident_push(Resident *resident, Resident_Command command, const char *name) {
+  Resident_Request request = { .command = command, .name = name ? strdup(name) : NULL };
+  mutex_lock(&resident->mutex);
+  nob_da_append(&resident->requests, request);
+  cond_signal(&resident->cond);
+  mutex_unlock(&resident->mutex);
+}
+
+// Takes the oldest request, waiting up to ms for one to show up. The caller frees request->name
+bool resident_take(Resident *resident, Resident_Request *request, uint32_t ms) {
+  mutex_lock(&resident->mutex);
+  if (resident->requests.count == 0 && ms > 0) {
+    if (ms == RESIDENT_WAIT_FOREVER) {
+      while (resident->requests.count == 0) cond_wait(&resident->cond, &resident->mutex);
+    } else {
+      cond_timed_wait(&resident->cond, &resident->mutex, ms);
+    }
+  }
+  bool got = resident->requests.count > 0;
+  if (got) {
+    *request = resident->requests.items[0];
+    resident->requests.count -= 1;
+    memmove(resident->requests.items, resident->requests.items + 1, resident->requests.count*sizeof(*request));
+  }
+  mutex_unlock(&resident->mutex);
+  return got;
+}
+
+#ifdef _WIN32
+// Resident mode is unix only, on Windows every lzua is its own instance
+bool resident_send(const char *path, const char *line) {
+  (void) path;
+  (void) line;
+  return false;
+}
+
+bool resident_listen(Resident *resident, const char *path) {
+  (void) resident;
+  (void) path;
+  nob_log(NOB_WARNING, "Resident mode is not supported on Windows yet, running as a normal instance");
+  return false;
+}
+#else
+bool resident_address(struct sockaddr_un *addr, const char *path) {
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  size_t len = strlen(path);
+  if (len >= sizeof(addr->sun_path)) {
+    nob_log(NOB_ERROR, "Socket path is too long: %s", path);
+    return false;
+  }
+  memcpy(addr->sun_path, path, len + 1);
+  return true;
+}
+
+int resident_connect(const char *path) {
+  struct sockaddr_un addr;
+  if (!resident_address(&addr, path)) return -1;
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// Reads one line, the connection is closed right after so whatever follows it is ignored
+bool resident_read_line(int fd, char *line, size_t size) {
+  size_t len = 0;
+  while (len + 1 < size) {
+    ssize_t n = read(fd, line + len, size - 1 - len);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    len += (size_t)n;
+    if (memchr(line, '\n', len)) break;
+  }
+  line[len] = '\0';
+  char *end = strchr(line, '\n');
+  if (end) *end = '\0';
+  return end != NULL;
+}
+
+bool resident_write_all(int fd, const char *data, size_t size) {
+  while (size > 0) {
+    ssize_t n = write(fd, data, size);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    data += n;
+    size -= (size_t)n;
+  }
+  return true;
+}
+
+// Hands the line to the resident instance. False when there is nobody listening, the caller starts up as usual then
+bool resident_send(const char *path, const char *line) {
+  int fd = resident_connect(path);
+  if (fd < 0) return false;
+  char reply[RESIDENT_LINE_MAX];
+  bool ok = resident_write_all(fd, line, strlen(line)) && resident_write_all(fd, "\n", 1)
+    && resident_read_line(fd, reply, sizeof(reply));
+  close(fd);
+  if (!ok) {
+    nob_log(NOB_ERROR, "Resident lzua at %s hung up without answering", path);
+  } else if (!streq(reply, "ok")) {
+    nob_log(NOB_ERROR, "Resident lzua: %s", reply);
+  }
+  return true;
+}
+
+void resident_serve(Resident *resident, int client) {
+  // A client that connects and says nothing must not hold up the next one
+  struct timeval timeout = { .tv_sec = 1 };
+  setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  char line[RESIDENT_LINE_MAX];
+  const char *reply = "ok\n";
+  if (!resident_read_line(client, line, sizeof(line))) {
+    reply = "incomplete request\n";
+  } else if (streq(line, "show")) {
+    resident_push(resident, RESIDENT_SHOW, NULL);
+  } else if (strncmp(line, "launch ", 7) == 0 && line[7] != '\0') {
+    resident_push(resident, RESIDENT_LAUNCH, line + 7);
+  } else if (streq(line, "quit")) {
+    resident_push(resident, RESIDENT_QUIT, NULL);
+  } else {
+    reply = "unknown request\n";
+  }
+  resident_write_all(client, reply, strlen(reply));
+  glfwPostEmptyEvent();
+}
+
+void resident_loop(void *arg) {
+  Resident *resident = arg;
+  while (true) {
+    int client = accept(resident->fd, NULL, NULL);
+    if (client < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      // resident_stop shut the socket down
+      break;
+    }
+    resident_serve(resident, client);
+    close(client);
+  }
+}
+
+// Becomes the resident instance. A socket file left behind by a crashed instance is taken over, one that still
+// answers means somebody else got there first
+bool resident_listen(Resident *resident, const char *path) {
+  struct sockaddr_un addr;
+  if (!resident_address(&addr, path)) return false;
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    nob_log(NOB_ERROR, "Could not create the resident socket: %s", strerror(errno));
+    return false;
+  }
+  // The games we launch have no business holding on to it
+  fcntl(fd, F_SETFD, FD_CLOEXEC);
+  // A client that hangs up before reading the answer must not take us down with it
+  signal(SIGPIPE, SIG_IGN);
+  bool bound = bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+  if (!bound && errno == EADDRINUSE) {
+    int other = resident_connect(path);
+    if (other >= 0) {
+      close(other);
+      close(fd);
+      nob_log(NOB_ERROR, "Another lzua is already resident at %s", path);
+      return false;
+    }
+    unlink(path);
+    bound = bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+  }
+  if (!bound || listen(fd, 8) < 0) {
+    nob_log(NOB_ERROR, "Could not listen on %s: %s", path, strerror(errno));
+    close(fd);
+    return false;
+  }
+
+  resident->fd = fd;
+  resident->path = strdup(path);
+  if (!thread_spawn(&resident->thread, resident_loop, resident)) {
+    nob_log(NOB_ERROR, "Could not start the resident listener");
+    unlink(path);
+    close(fd);
+    free(resident->path);
+    resident->path = NULL;
+    resident->fd = -1;
+    return false;
+  }
+  resident->listening = true;
+  nob_log(NOB_INFO, "Resident at %s", path);
+  return true;
+}
+
+#endif // _WIN32
+
+void resident_stop(Resident *resident) {
+  #ifndef _WIN32
+  if (resident->listening) {
+    shutdown(resident->fd, SHUT_RDWR);
+    thread_join(resident->thread);
+    close(resident->fd);
+    unlink(resident->path);
+    free(resident->path);
+    resident->listening = false;
+  }
+  #endif // _WIN32
+  for (size_t i = 0; i < resident->requests.count; ++i) free(resident->requests.items[i].name);
+  nob_da_free(resident->requests);
+}
+
+// Reads the games folder again. The games that are still there keep the alias the library gave them, everything
+// else derived from the catalog catches up through its version
+bool games_rescan(const char *games_dir, Games *games, const Library *lib) {
+  Games fresh = { .version = games->version };
+  if (!read_games_dir(games_dir, &fresh)) {
+    free(fresh.items);
+    return false;
+  }
+  for (size_t i = 0; i < fresh.count; ++i) {
+    Game *game = &fresh.items[i];
+    size_t save = nob_temp_save();
+    size_t old = library_find(lib, nob_temp_sprintf("%s/%s", game->name, game->exe));
+    nob_temp_rewind(save);
+    if (old != SIZE_MAX) game->alias = games->items[old].alias;
+  }
+  free(games->items);
+  *games = fresh;
+  return true;
+}
+
+bool streq_folded(const char *a, const char *b) {
+  while (*a && fold_ascii(*a) == fold_ascii(*b)) {
+    a += 1;
+    b += 1;
+  }
+  return *a == '\0' && *b == '\0';
+}
+
+// The title is whatever the user typed after --launch, so case does not matter and the folder name works too
+size_t find_game_by_title(const Games *games, const char *title) {
+  for (size_t i = 0; i < games->count; ++i) {
+    if (streq_folded(game_title(&games->items[i]), title)) return i;
+  }
+  for (size_t i = 0; i < games->count; ++i) {
+    if (streq_folded(games->items[i].name, title)) return i;
+  }
+  return SIZE_MAX;
+}
+
+
+#define RENDER_POLL_FPS 4
+#define RENDER_FALLBACK_FPS 60
+#define RENDER_MAX_FRAME_TIME (1.0f/30.0f)
+
+typedef enum {
+  // Nothing is going on, sleep in EndDrawing until the OS hands us an event
+  RENDER_IDLE,
+  // Something can change without an input event (a game running, background work), so wake up every now and then
+  // to check on it but only draw when something actually changed
+  RENDER_POLL,
+  // Something is moving on screen, draw every frame up to the refresh rate of the monitor
+  RENDER_ANIMATE,
+} Render_Mode;
+
+typedef struct {
+  Render_Mode mode;
+  bool dirty;
+} Render_Scheduler;
+
+void render_scheduler_init(Render_Scheduler *rs) {
+  int fps = GetMonitorRefreshRate(GetCurrentMonitor());
+  SetTargetFPS(fps > 0 ? fps : RENDER_FALLBACK_FPS);
+  EnableEventWaiting();
+  rs->mode = RENDER_IDLE;
+  rs->dirty = true;
+}
+
+// For things that change what is on screen without an input event
+void render_scheduler_invalidate(Render_Scheduler *rs) {
+  rs->dirty = true;
+}
+
+bool render_input_happened(void) {
+  Vector2 delta = GetMouseDelta();
+  if (delta.x != 0 || delta.y != 0) return true;
+  if (GetMouseWheelMove() != 0) return true;
+  for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_BACK; ++button) {
+    if (IsMouseButtonPressed(button) || IsMouseButtonReleased(button)) return true;
+  }
+  return IsWindowResized();
+}
+
+// When false the caller must skip the frame with render_scheduler_skip_frame
+bool render_scheduler_should_draw(Render_Scheduler *rs) {
+  // In the other modes we only got here because there was an event or because we are animating
+  if (rs->mode != RENDER_POLL) return true;
+  return rs->dirty || render_input_happened();
+}
+
+void render_scheduler_skip_frame(Render_Scheduler *rs) {
+  NOB_ASSERT(rs->mode == RENDER_POLL && "Frames are only skipped while polling");
+  PollInputEvents();
+  // Any event cuts the wait short, the input it brings shows up on the next frame instead of after the interval
+  glfwWaitEventsTimeout(1.0/RENDER_POLL_FPS);
+}
+
+// Picks how to wait for the next frame, call it right before EndDrawing
+void render_scheduler_end_frame(Render_Scheduler *rs, bool animating, bool background_pending) {
+  Render_Mode mode = RENDER_IDLE;
+  if (animating) mode = RENDER_ANIMATE;
+  else if (background_pending) mode = RENDER_POLL;
+  rs->dirty = false;
+  if (mode == rs->mode) return;
+
+  if (mode == RENDER_IDLE) EnableEventWaiting();
+  else if (rs->mode == RENDER_IDLE) DisableEventWaiting();
+  rs->mode = mode;
+}
+
+// The window is about to be hidden. Whatever input closed it is consumed now so it does not close it again the
+// moment it comes back, and event waiting goes off since nothing is going to send the hidden window any events
+void render_scheduler_suspend(Render_Scheduler *rs) {
+  if (rs->mode == RENDER_IDLE) DisableEventWaiting();
+  PollInputEvents();
+  rs->mode = RENDER_POLL;
+  rs->dirty = true;
+}
+
+
+// Frame profiler shown with F3. Only compiled in when LZUA_PROFILER is set (debug builds set it by default), so
+// release builds do not even read the clock
+#ifndef LZUA_PROFILER
+#  ifdef BUILD_DEBUG
+#    define LZUA_PROFILER 1
+#  else
+#    define LZUA_PROFILER 0
+#  endif // BUILD_DEBUG
+#endif // LZUA_PROFILER
+
+#define PROFILER_HISTORY 240
+#define PROFILER_TOGGLE_KEY KEY_F3
+
+typedef enum {
+  PROF_DRAIN,
+  PROF_LAYOUT,
+  PROF_HIT_TEST,
+  PROF_DRAW,
+  PROF_SWAP,
+  PROF_PHASE_COUNT,
+} Prof_Phase;
+
+static const char *prof_phase_names[PROF_PHASE_COUNT] = {
+  [PROF_DRAIN]    = "drain",
+  [PROF_LAYOUT]   = "layout",
+  [PROF_HIT_TEST] = "hit-test",
+  [PROF_DRAW]     = "draw",
+  [PROF_SWAP]     = "swap",
+};
+
+typedef struct {
+  bool visible;
+  uint64_t started[PROF_PHASE_COUNT];
+  uint64_t current[PROF_PHASE_COUNT];
+  // Phases of the last finished frame, what the overlay shows
+  uint64_t last[PROF_PHASE_COUNT];
+  // CPU time of every frame up to EndDrawing, which also waits for the next frame and would drown everything else
+  float history[PROFILER_HISTORY];
+  size_t head;
+  size_t filled;
+  size_t dropped;
+  float budget_ms;
+  // Every frame drawn since the start, for the report at exit
+  List(float) session;
+  uint64_t session_started;
+  double session_cpu;
+  uint64_t session_tiles;
+  // Wakeups while polling that found nothing to draw
+  size_t session_skipped;
+  bool tiles_shaded;
+  // A/B switches that turn an optimization off so the report shows what it saves. They come from the environment
+  // so one build runs both ways, and are always off without the profiler
+  bool no_layout_cache;
+  bool no_tile_shader;
+} Profiler;
+
+#if LZUA_PROFILER
+#  define PROF_BEGIN(prof, phase) profiler_begin((prof), (phase))
+#  define PROF_END(prof, phase) profiler_end((prof), (phase))
+#else
+#  define PROF_BEGIN(prof, phase) ((void)0)
+#  define PROF_END(prof, phase) ((void)0)
+#endif // LZUA_PROFILER
+
+// User and system time of the whole process, the worker threads included
+double process_cpu_seconds(void) {
+  #ifdef _WIN32
+  FILETIME creation, exit, kernel, user;
+  if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) return 0;
+  uint64_t k = ((uint64_t)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+  uint64_t u = ((uint64_t)user.dwHighDateTime << 32) | user.dwLowDateTime;
+  return (k + u)/1e7;
+  #else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) < 0) return 0;
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec)/1e6;
+  #endif // _WIN32
+}
+
+void profiler_start(Profiler *prof) {
+  prof->session_started = nob_nanos_since_unspecified_epoch();
+  prof->session_cpu = process_cpu_seconds();
+  #if LZUA_PROFILER
+  prof->no_layout_cache = getenv("LZUA_AB_NO_LAYOUT_CACHE") != NULL;
+  if (prof->no_layout_cache) nob_log(NOB_INFO, "Profiler: laying out the grid again every frame");
+  prof->no_tile_shader = getenv("LZUA_AB_NO_TILE_SHADER") != NULL;
+  if (prof->no_tile_shader) nob_log(NOB_INFO, "Profiler: drawing tiles as rounded shapes");
+  #endif // LZUA_PROFILER
+}
+
+void profiler_begin(Profiler *prof, Prof_Phase phase) {
+  prof->started[phase] = nob_nanos_since_unspecified_epoch();
+}
+
+void profiler_end(Profiler *prof, Prof_Phase phase) {
+  prof->current[phase] += nob_nanos_since_unspecified_epoch() - prof->started[phase];
+}
+
+void profiler_count_tiles(Profiler *prof, size_t count, bool shaded) {
+  #if LZUA_PROFILER
+  prof->session_tiles += count;
+  prof->tiles_shaded = shaded;
+  #else
+  (void) prof;
+  (void) count;
+  (void) shaded;
+  #endif // LZUA_PROFILER
+}
+
+void profiler_count_skip(Profiler *prof) {
+  #if LZUA_PROFILER
+  prof->session_skipped += 1;
+  #else
+  (void) prof;
+  #endif // LZUA_PROFILER
+}
+
+// Returns true when the overlay was toggled
+bool profiler_update(Profiler *prof) {
+  #if LZUA_PROFILER
+  if (!IsKeyPressed(PROFILER_TOGGLE_KEY)) return false;
+  prof->visible = !prof->visible;
+  memset(prof->current, 0, sizeof(prof->current));
+  int fps = GetMonitorRefreshRate(GetCurrentMonitor());
+  prof->budget_ms = 1000.0f/(fps > 0 ? fps : RENDER_FALLBACK_FPS);
+  return true;
+  #else
+  (void) prof;
+  return false;
+  #endif // LZUA_PROFILER
+}
+
+// The session keeps counting with the overlay hidden, the history is only what the overlay shows
+void profiler_frame_end(Profiler *prof) {
+  #if LZUA_PROFILER
+  uint64_t cpu = 0;
+  for (size_t i = 0; i < PROF_PHASE_COUNT; ++i) {
+    if (i != PROF_SWAP) cpu += prof->current[i];
+  }
+  float cpu_ms = cpu/1e6f;
+  nob_da_append(&prof->session, cpu_ms);
+  if (prof->visible) {
+    prof->history[prof->head] = cpu_ms;
+    prof->head = (prof->head + 1)%PROFILER_HISTORY;
+    if (prof->filled < PROFILER_HISTORY) prof->filled += 1;
+    if (cpu_ms > prof->budget_ms) prof->dropped += 1;
+    memcpy(prof->last, prof->current, sizeof(prof->last));
+  }
+  memset(prof->current, 0, sizeof(prof->current));
+  #else
+  (void) prof;
+  #endif // LZUA_PROFILER
+}
+
+int compare_floats(const void *a, const void *b) {
+  float x = *(const float*)a, y = *(const float*)b;
+  return (x > y) - (x < y);
+}
+
+// Logged at exit so frame times and idle CPU can be compared between two builds, or two runs of one with an A/B
+// switch flipped, without reading them off the overlay
+void profiler_report(Profiler *prof) {
+  #if LZUA_PROFILER
+  double wall = (nob_nanos_since_unspecified_epoch() - prof->session_started)/1e9;
+  double cpu = process_cpu_seconds() - prof->session_cpu;
+  size_t frames = prof->session.count;
+  double sum = 0;
+  for (size_t i = 0; i < frames; ++i) sum += prof->session.items[i];
+  qsort(prof->session.items, frames, sizeof(float), compare_floats);
+  float p50 = frames ? prof->session.items[frames/2] : 0;
+  float p99 = frames ? prof->session.items[(frames*99)/100] : 0;
+  nob_log(NOB_INFO, "Profiler: %zu frames drawn in %.1fs, frame cpu mean %.3f p50 %.3f p99 %.3f ms", frames, wall,
+          frames ? sum/frames : 0, p50, p99);
+  nob_log(NOB_INFO, "Profiler: process cpu %.2fs over %.1fs (%.2f%% of a core)", cpu, wall,
+          wall > 0 ? cpu/wall*100 : 0);
+  nob_log(NOB_INFO, "Profiler: %zu wakeups drew nothing, %.2f wakeups per second in total", prof->session_skipped,
+          wall > 0 ? (frames + prof->session_skipped)/wall : 0);
+  // Both paths so one run says what the other would cost, the focus outline and the art are left out
+  double tiles = frames ? (double)prof->session_tiles/frames : 0;
+  nob_log(NOB_INFO, "Profiler: %.0f tiles per frame, drawn as %s; %.0f vertices per frame with the shader (%d per tile), "
+          "%.0f with shapes (%d per tile)", tiles, prof->tiles_shaded ? "shader" : "shapes",
+          tiles*GAME_BUTTON_SHADER_VERTICES, GAME_BUTTON_SHADER_VERTICES, tiles*GAME_BUTTON_SHAPE_VERTICES,
+          GAME_BUTTON_SHAPE_VERTICES);
+  nob_da_free(prof->session);
+  #else
+  (void) prof;
+  #endif // LZUA_PROFILER
+}
+
+void profiler_draw(const Profiler *prof) {
+  if (!prof->visible) return;
+
+  const int font_size = 10;
+  const int line = font_size + 2;
+  const int width = PROFILER_HISTORY + 8;
+  const int height = line*(PROF_PHASE_COUNT + 3) + 60 + 8;
+  int x = GetScreenWidth() - width - 4;
+  int y = 4;
+  DrawRectangle(x, y, width, height, RGBa(0, 0, 0, 200));
+  x += 4;
+  y += 4;
+
+  size_t save = nob_temp_save();
+  for (size_t i = 0; i < PROF_PHASE_COUNT; ++i) {
+    DrawText(nob_temp_sprintf("%-9s %7.3f ms", prof_phase_names[i], prof->last[i]/1e6), x, y, font_size, RAYWHITE);
+    y += line;
+  }
+
+  float sorted[PROFILER_HISTORY];
+  memcpy(sorted, prof->history, sizeof(float)*prof->filled);
+  qsort(sorted, prof->filled, sizeof(float), compare_floats);
+  float p50 = prof->filled ? sorted[prof->filled/2] : 0;
+  float p99 = prof->filled ? sorted[(prof->filled*99)/100] : 0;
+  float max = prof->filled ? sorted[prof->filled - 1] : 0;
+  DrawText(nob_temp_sprintf("cpu p50 %.3f  p99 %.3f  max %.3f ms", p50, p99, max), x, y, font_size, RAYWHITE);
+  y += line;
+  DrawText(nob_temp_sprintf("over %.1f ms budget: %zu frames", prof->budget_ms, prof->dropped), x, y, font_size, RAYWHITE);
+  y += line*2;
+  nob_temp_rewind(save);
+
+  // Bars are scaled so the budget of a frame sits at the top of the graph
+  const int graph_height = 60;
+  for (size_t i = 0; i < prof->filled; ++i) {
+    float ms = prof->history[(prof->head + PROFILER_HISTORY - prof->filled + i)%PROFILER_HISTORY];
+    int bar = (int)(ms/prof->budget_ms*graph_height);
+    if (bar > graph_height) bar = graph_height;
+    if (bar < 1) bar = 1;
+    Color color = ms > prof->budget_ms ? RED : GREEN;
+    DrawRectangle(x + (int)i, y + graph_height - bar, 1, bar, color);
+  }
+}
+
+
+#if LZUA_TESTS
+// Self tests and benchmarks. Only built into build/lzua-test by `./nob test` and `./nob bench`, lzua itself never
+// has them. Each test checks as much as it can and says what went wrong, the run fails if any check did
+typedef struct {
+  const char *name;
+  size_t checks;
+  size_t failures;
+} Test;
+
+#define TEST_CHECK(test, cond, ...)                                     \
+  do {                                                                  \
+    (test)->checks += 1;                                                \
+    if (!(cond)) {                                                      \
+      if ((test)->failures++ < 10) {                                    \
+        nob_log(NOB_ERROR, "%s:%d: %s: check failed: %s", __FILE__, __LINE__, (test)->name, #cond); \
+        nob_log(NOB_ERROR, __VA_ARGS__);                                \
+      }                                                                 \
+    }                                                                   \
+  } while (0)
+
+typedef void (*Test_Func)(Test *test);
+typedef void (*Bench_Func)(void);
+
+// xorshift64, the tests have to see the same inputs on every run
+uint64_t test_random(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return *state = x;
+}
+
+typedef struct {
+  const char *name;
+  Substring_Find_Func find;
+} Substring_Kernel;
+
+size_t substring_kernels(Substring_Kernel kernels[3]) {
+  size_t count = 0;
+  kernels[count++] = (Substring_Kernel) { "scalar", substring_find_scalar };
+  #if SUBSTRING_SIMD
+  kernels[count++] = (Substring_Kernel) { "SSE2", substring_find_sse2 };
+  if (cpu_has_avx2()) kernels[count++] = (Substring_Kernel) { "AVX2", substring_find_avx2 };
+  #endif // SUBSTRING_SIMD
+  return count;
+}
+
+#define SUBSTRING_TEST_MAX_HAY 100
+#define SUBSTRING_TEST_MAX_NEEDLE 40
+
+// Every kernel against the scalar one, at every alignment of the haystack within a 32 byte block, for haystacks and
+// needles of every length up to a few blocks. Needles come from the haystack itself so they are found, cross the 16
+// and 32 byte boundaries from every offset, and the alphabet is two letters so first and last bytes match a lot
+void test_substring_kernels(Test *test) {
+  Substring_Kernel kernels[3];
+  size_t kernel_count = substring_kernels(kernels);
+  char *buffer = malloc(32 + SUBSTRING_TEST_MAX_HAY + SUBSTRING_PADDING);
+  NOB_ASSERT(buffer != NULL && "Buy more RAM lol");
+  char needle[SUBSTRING_TEST_MAX_NEEDLE];
+  uint64_t rng = 0x9e3779b97f4a7c15ULL;
+  for (size_t align = 0; align < 32; ++align) {
+    for (size_t len = 0; len <= SUBSTRING_TEST_MAX_HAY; ++len) {
+      // The padding gets the same letters so a kernel reading past len would find matches there
+      for (size_t i = 0; i < 32 + SUBSTRING_TEST_MAX_HAY + SUBSTRING_PADDING; ++i) buffer[i] = 'a' + test_random(&rng)%2;
+      const char *hay = buffer + align;
+      for (size_t needle_len = 1; needle_len <= SUBSTRING_TEST_MAX_NEEDLE; ++needle_len) {
+        for (int variant = 0; variant < 3; ++variant) {
+          if (variant == 0 && needle_len <= len) {
+            // Taken from the haystack, so it is there at least once
+            memcpy(needle, hay + test_random(&rng)%(len - needle_len + 1), needle_len);
+          } else if (variant == 1) {
+            for (size_t i = 0; i < needle_len; ++i) needle[i] = 'a' + test_random(&rng)%2;
+          } else {
+            // Right first and last byte with something in the middle that is never there
+            for (size_t i = 0; i < needle_len; ++i) needle[i] = 'a' + test_random(&rng)%2;
+            if (needle_len > 2) needle[needle_len/2] = 'z';
+          }
+          size_t expected = substring_find_scalar(hay, len, needle, needle_len);
+          for (size_t k = 1; k < kernel_count; ++k) {
+            size_t found = kernels[k].find(hay, len, needle, needle_len);
+            TEST_CHECK(test, found == expected, "%s: align %zu, hay %.*s, needle %.*s: found %zu, expected %zu",
+                       kernels[k].name, align, (int)len, hay, (int)needle_len, needle, found, expected);
+          }
+        }
+      }
+    }
+  }
+  free(buffer);
+}
+
+// Somewhere to write the files of a test, the system temporary directory so running them leaves nothing behind in
+// the tree
+const char *test_temp_path(const char *name) {
+  #ifdef _WIN32
+  const char *dir = getenv("TEMP");
+  if (!dir) dir = ".";
+  #else
+  const char *dir = getenv("TMPDIR");
+  if (!dir) dir = "/tmp";
+  #endif // _WIN32
+  return nob_temp_sprintf("%s%clzua-test-%s", dir, PATH_DELIM, name);
+}
+
+#define TEST_LIBRARY_GAMES 50
+
+// A catalog with a bit of everything in its stats, the folders do not exist so added falls back to now
+void test_library_catalog(Games *games, Library *lib, size_t count) {
+  *games = (Games) {0};
+  for (size_t i = 0; i < count; ++i) {
+    Game game = {
+      .folder = intern_cstr(&path_interns, nob_temp_sprintf("/nonexistent/game%zu/", i)),
+      .name = intern_cstr(&title_interns, nob_temp_sprintf("game%zu", i)),
+      .exe = intern_cstr(&path_interns, "run.sh"),
+    };
+    nob_da_append(games, game);
+  }
+  games->version += 1;
+  *lib = (Library) {0};
+  library_sync(lib, games);
+  lib->changes.count = 0;
+}
+
+void test_library_fill(Games *games, Library *lib) {
+  for (size_t i = 0; i < games->count; ++i) {
+    Game_Stats *stats = &lib->stats.items[i];
+    stats->launches = (uint32_t)i;
+    stats->last_launch = 1700000000 + (int64_t)i;
+    stats->frecency = i*0.25;
+    stats->playtime = (int64_t)i*60;
+    stats->size = i*1024;
+    stats->size_mtime = 1600000000 + (int64_t)i;
+    stats->added = 1500000000 + (int64_t)i;
+    if (i%3 == 0) stats->extra = intern_cstr(&title_interns, nob_temp_sprintf("tags = t%zu\n", i));
+    if (i%5 == 0) games->items[i].alias = intern_cstr(&title_interns, nob_temp_sprintf("Alias %zu", i));
+  }
+  nob_sb_append_cstr(&lib->orphans, "\n[gone/run.sh]\nadded = 1\n");
+  library_build_orders(lib);
+}
+
+// Loads path into a fresh library over a fresh copy of the catalog and compares it with what was saved
+bool test_library_load(Test *test, const char *path, const Games *want_games, const Library *want, Library *got,
+                       Games *got_games) {
+  test_library_catalog(got_games, got, want_games->count);
+  bool aliased = false, sorted = false;
+  if (!library_load_binary(got, path, got_games, &aliased, &sorted)) return false;
+  for (size_t i = 0; i < want_games->count; ++i) {
+    const Game_Stats *a = &want->stats.items[i], *b = &got->stats.items[i];
+    TEST_CHECK(test, a->launches == b->launches && a->last_launch == b->last_launch && a->frecency == b->frecency
+               && a->playtime == b->playtime && a->size == b->size && a->size_mtime == b->size_mtime
+               && a->added == b->added, "stats of game %zu differ", i);
+    TEST_CHECK(test, a->extra == b->extra, "extra of game %zu: %s vs %s", i, a->extra ? a->extra : "-",
+               b->extra ? b->extra : "-");
+    TEST_CHECK(test, want_games->items[i].alias == got_games->items[i].alias, "alias of game %zu differs", i);
+  }
+  TEST_CHECK(test, sorted, "the saved orders were not taken");
+  TEST_CHECK(test, got->orphans.count == want->orphans.count
+             && memcmp(got->orphans.items, want->orphans.items, want->orphans.count) == 0, "orphans differ");
+  return true;
+}
+
+// Rewrites the header of a v2 file after its sections were edited so only what the test broke is broken
+void test_library_reseal(Nob_String_Builder *file) {
+  Library_File_Header header = {0};
+  memcpy(&header, file->items, sizeof(header));
+  header.size = (uint32_t)(file->count - sizeof(header));
+  header.crc = ComputeCRC32((unsigned char *)file->items + sizeof(header), (int)header.size);
+  memcpy(file->items, &header, sizeof(header));
+}
+
+void test_library_binary(Test *test) {
+  Games games = {0}, got_games = {0};
+  Library lib = {0}, got = {0};
+  test_library_catalog(&games, &lib, TEST_LIBRARY_GAMES);
+  test_library_fill(&games, &lib);
+  const char *path = strdup(test_temp_path("library.lzua.bin"));
+  const char *broken = strdup(test_temp_path("broken.lzua.bin"));
+  TEST_CHECK(test, library_save_binary(&lib, path, &games), "could not save %s", path);
+  Nob_String_Builder saved = {0};
+  TEST_CHECK(test, nob_read_entire_file(path, &saved), "could not read %s back", path);
+
+  // What was saved comes back as it was
+  TEST_CHECK(test, test_library_load(test, path, &games, &lib, &got, &got_games), "round trip did not load");
+  library_free(&got);
+
+  // Sections it does not know are skipped, the lowercase ones are written back as they came and the rest dropped
+  Nob_String_Builder file = {0};
+  nob_sb_append_buf(&file, saved.items, saved.count);
+  const char kept_payload[] = "from a newer build";
+  size_t at = library_begin_section(&file, LIBRARY_SECTION_TAG('x', 't', 'r', 'a'));
+  nob_sb_append_buf(&file, kept_payload, sizeof(kept_payload));
+  library_end_section(&file, at);
+  at = library_begin_section(&file, LIBRARY_SECTION_TAG('Z', 'Z', 'Z', 'Z'));
+  nob_sb_append_cstr(&file, "records of a newer build");
+  library_end_section(&file, at);
+  test_library_reseal(&file);
+  TEST_CHECK(test, nob_write_entire_file(broken, file.items, file.count), "could not write %s", broken);
+  TEST_CHECK(test, test_library_load(test, broken, &games, &lib, &got, &got_games), "unknown sections did not load");
+  TEST_CHECK(test, got.kept_sections.count == LIBRARY_SECTION_ALIGN(sizeof(kept_payload)) + sizeof(Library_File_Section),
+             "kept %zu bytes of unknown sections", got.kept_sections.count);
+  TEST_CHECK(test, library_save_binary(&got, broken, &got_games), "could not save %s again", broken);
+  Nob_String_Builder again = {0};
+  TEST_CHECK(test, nob_read_entire_file(broken, &again), "could not read %s back", broken);
+  bool has_kept = false, has_dropped = false;
+  for (size_t i = 0; i + sizeof(kept_payload) <= again.count; ++i) {
+    if (memcmp(again.items + i, kept_payload, sizeof(kept_payload)) == 0) has_kept = true;
+    if (memcmp(again.items + i, "records of a newer build", 24) == 0) has_dropped = true;
+  }
+  TEST_CHECK(test, has_kept && !has_dropped, "saving again kept %d and dropped %d", has_kept, !has_dropped);
+  library_free(&got);
+  free(again.items);
+
+  // A bit flipped anywhere after the header fails the CRC and leaves the library as it was
+  file.count = 0;
+  nob_sb_append_buf(&file, saved.items, saved.count);
+  file.items[file.count/2] ^= 0x40;
+  TEST_CHECK(test, nob_write_entire_file(broken, file.items, file.count), "could not write %s", broken);
+  TEST_CHECK(test, !test_library_load(test, broken, &games, &lib, &got, &got_games), "corrupted file loaded");
+  TEST_CHECK(test, got.stats.items[7].launches == 0 && got.kept_sections.count == 0, "corrupted file left data");
+  library_free(&got);
+
+  // Cut short, and a section that says it is longer than the file even with a CRC that matches
+  for (int sealed = 0; sealed < 2; ++sealed) {
+    file.count = 0;
+    nob_sb_append_buf(&file, saved.items, saved.count - 8);
+    if (sealed) {
+      at = library_begin_section(&file, LIBRARY_SECTION_TAG('x', 't', 'r', 'a'));
+      library_end_section(&file, at);
+      Library_File_Section section = { .tag = LIBRARY_SECTION_TAG('x', 't', 'r', 'a'), .size = 4096 };
+      memcpy(file.items + at, &section, sizeof(section));
+      test_library_reseal(&file);
+    }
+    TEST_CHECK(test, nob_write_entire_file(broken, file.items, file.count), "could not write %s", broken);
+    TEST_CHECK(test, !test_library_load(test, broken, &games, &lib, &got, &got_games), "truncated file loaded (%d)",
+               sealed);
+    library_free(&got);
+  }
+
+  // The first binary: records without the fields added since, orders and strings at fixed places after the header
+  Nob_String_Builder strings = {0};
+  Nob_String_Builder body = {0};
+  size_t v1_record_size = sizeof(Library_File_Record) - 2*sizeof(uint32_t);
+  for (size_t i = 0; i < games.count; ++i) {
+    const Game_Stats *stats = &lib.stats.items[i];
+    Library_File_Record record = {
+      .key = library_add_string(&strings, lib.keys.items[i]),
+      .alias = games.items[i].alias ? library_add_string(&strings, games.items[i].alias) : LIBRARY_NO_STRING,
+      .launches = stats->launches, .last_launch = stats->last_launch, .frecency = stats->frecency,
+      .playtime = stats->playtime, .size = stats->size, .size_mtime = stats->size_mtime, .added = stats->added,
+    };
+    nob_sb_append_buf(&body, (const char *)&record, v1_record_size);
+  }
+  for (int mode = 0; mode < SORT_MODE_COUNT; ++mode) {
+    for (size_t i = 0; i < games.count; ++i) {
+      uint32_t index = (uint32_t)lib.orders[mode].items[i];
+      nob_sb_append_buf(&body, (const char *)&index, sizeof(index));
+    }
+  }
+  uint32_t orphans = (uint32_t)strings.count;
+  nob_sb_append_buf(&strings, lib.orphans.items, lib.orphans.count);
+  nob_sb_append_null(&strings);
+  nob_sb_append_buf(&body, strings.items, strings.count);
+  Library_File_Header_V1 v1 = {
+    .magic = LIBRARY_BINARY_MAGIC, .version = 1, .record_count = (uint32_t)games.count,
+    .strings_size = (uint32_t)strings.count, .orphans = orphans,
+    .crc = ComputeCRC32((unsigned char *)body.items, (int)body.count),
+  };
+  file.count = 0;
+  nob_sb_append_buf(&file, (const char *)&v1, sizeof(v1));
+  nob_sb_append_buf(&file, body.items, body.count);
+  TEST_CHECK(test, nob_write_entire_file(broken, file.items, file.count), "could not write %s", broken);
+  // v1 had no extra fields, what is compared is what it had
+  Library without_extra = {0};
+  nob_da_append_many(&without_extra.stats, lib.stats.items, lib.stats.count);
+  for (size_t i = 0; i < without_extra.stats.count; ++i) without_extra.stats.items[i].extra = NULL;
+  without_extra.orphans = lib.orphans;
+  TEST_CHECK(test, test_library_load(test, broken, &games, &without_extra, &got, &got_games), "v1 did not load");
+  library_free(&got);
+  free(without_extra.stats.items);
+
+  remove(path);
+  remove(broken);
+  free(strings.items);
+  free(body.items);
+  free(file.items);
+  free(saved.items);
+  library_free(&lib);
+  free((char *)path);
+  free((char *)broken);
+}
+
+// Names built from a few words so queries hit a realistic share of the catalog, seeded so every run gets the same
+Games test_search_catalog(size_t count, uint64_t seed) {
+  static const char *words[] = {
+    "Super", "Dragon", "Quest", "Legend", "of", "the", "Dark", "Souls", "Space", "Tactics", "Racing", "Farm",
+    "Simulator", "Kingdom", "Hearts", "Final", "Fantasy", "Metal", "Gear", "Solid", "Hollow", "Knight", "Star",
+    "Wars", "Puzzle", "Island", "Zero", "Mystery", "Castle", "Ninja", "Robot", "Ocean", "Forest", "Tower",
+  };
+  Games games = {0};
+  uint64_t rng = seed;
+  for (size_t i = 0; i < count; ++i) {
+    Nob_String_Builder name = {0};
+    size_t word_count = 1 + test_random(&rng)%4;
+    for (size_t w = 0; w < word_count; ++w) {
+      if (w > 0) nob_sb_append_cstr(&name, " ");
+      nob_sb_append_cstr(&name, words[test_random(&rng)%NOB_ARRAY_LEN(words)]);
+    }
+    nob_sb_appendf(&name, " %zu", i);
+    nob_sb_append_null(&name);
+    Game game = {
+      .folder = intern_cstr(&path_interns, "/nonexistent/"),
+      .name = intern_cstr(&title_interns, name.items),
+      .exe = intern_cstr(&path_interns, "run.sh"),
+    };
+    if (test_random(&rng)%8 == 0) game.alias = intern_cstr(&title_interns, words[test_random(&rng)%NOB_ARRAY_LEN(words)]);
+    nob_da_append(&games, game);
+    free(name.items);
+  }
+  games.version += 1;
+  return games;
+}
+
+// Every query typed and backspaced at random has to give the same ordered view as the same query searched from
+// scratch
+void test_search_incremental(Test *test) {
+  Games games = test_search_catalog(5000, 7);
+  static const char alphabet[] = "aeiorstdkq '";
+  Search search = {0}, scratch = {0};
+  search_sync(&search, &games);
+  search_sync(&scratch, &games);
+  uint64_t rng = 3;
+  for (size_t sequence = 0; sequence < 200; ++sequence) {
+    search_clear(&search);
+    for (size_t step = 0; step < 16; ++step) {
+      if (search.depth > 0 && test_random(&rng)%4 == 0) {
+        search_pop(&search);
+      } else {
+        char c = alphabet[test_random(&rng)%(NOB_ARRAY_LEN(alphabet) - 1)];
+        search_append(&search, &games, &c, 1);
+      }
+      search_clear(&scratch);
+      if (search.query.count > 0) search_append(&scratch, &games, search.query.items, search.query.count);
+      Game_View got = search_view(&search), want = search_view(&scratch);
+      TEST_CHECK(test, got.count == want.count && memcmp(got.items, want.items, sizeof(*got.items)*got.count) == 0,
+                 "query \"%.*s\": %zu results typed, %zu from scratch", (int)search.query.count, search.query.items,
+                 got.count, want.count);
+    }
+  }
+  search_free(&search);
+  search_free(&scratch);
+  free(games.items);
+}
+
+// What a filter test library was given for each game, so the brute force does not go through the columns it checks
+typedef struct {
+  bool tags[3];
+  // NAN when the game has none or it is not a number
+  double rating;
+  const char *rating_text;
+  const char *genre;
+} Test_Filter_Game;
+
+static const char *test_filter_tags[] = { "coop", "rpg", "horror" };
+#define TEST_FILTER_NOW 1750000000
+#define TEST_FILTER_DAY (24*60*60)
+
+// A library over test_search_catalog with random stats, some of them missing, tags and a rating and genre field
+Test_Filter_Game *test_filter_library(Games *games, Library *lib, size_t count, uint64_t seed) {
+  *games = test_search_catalog(count, seed);
+  *lib = (Library) {0};
+  library_sync(lib, games);
+  lib->changes.count = 0;
+  Test_Filter_Game *expect = calloc(count, sizeof(*expect));
+  NOB_ASSERT(expect != NULL && "Buy more RAM lol");
+  uint64_t rng = seed;
+  Nob_String_Builder extra = {0};
+  for (size_t i = 0; i < count; ++i) {
+    Game_Stats *stats = &lib->stats.items[i];
+    Test_Filter_Game *g = &expect[i];
+    *stats = (Game_Stats) {0};
+    if (test_random(&rng)%5 != 0) stats->size = test_random(&rng)%((uint64_t)100 << 30);
+    stats->playtime = (int64_t)(test_random(&rng)%(100*60*60));
+    if (test_random(&rng)%3 != 0) {
+      stats->launches = 1 + (uint32_t)(test_random(&rng)%10);
+      stats->last_launch = TEST_FILTER_NOW - (int64_t)(test_random(&rng)%(2*365*TEST_FILTER_DAY));
+      stats->frecency = 1;
+    }
+    if (test_random(&rng)%10 != 0) stats->added = TEST_FILTER_NOW - (int64_t)(test_random(&rng)%(3*365*TEST_FILTER_DAY));
+
+    extra.count = 0;
+    nob_sb_append_cstr(&extra, "tags =");
+    for (size_t t = 0; t < NOB_ARRAY_LEN(test_filter_tags); ++t) {
+      g->tags[t] = test_random(&rng)%3 == 0;
+      if (g->tags[t]) nob_sb_appendf(&extra, " %s,", test_filter_tags[t]);
+    }
+    nob_sb_append_cstr(&extra, "\n");
+    g->rating = NAN;
+    uint64_t rating = test_random(&rng)%13;
+    if (rating <= 10) {
+      g->rating = (double)rating;
+      g->rating_text = nob_temp_sprintf("%d", (int)rating);
+    } else if (rating == 11) {
+      g->rating_text = "great";
+    }
+    if (g->rating_text) nob_sb_appendf(&extra, "meta.rating = %s\n", g->rating_text);
+    uint64_t genre = test_random(&rng)%3;
+    if (genre < 2) {
+      g->genre = genre == 0 ? "horror" : "puzzle";
+      nob_sb_appendf(&extra, "meta.Genre = %s\n", genre == 0 ? "Horror" : "puzzle");
+    }
+    nob_sb_append_null(&extra);
+    stats->extra = intern_cstr(&title_interns, extra.items);
+    nob_temp_reset();
+  }
+  free(extra.items);
+  library_build_orders(lib);
+  library_meta_build(&lib->meta, lib);
+  return expect;
+}
+
+bool test_filter_has_text(const Game *game, const char *word) {
+  const char *texts[] = { game->name, game->alias, game->exe };
+  for (size_t t = 0; t < NOB_ARRAY_LEN(texts); ++t) {
+    if (!texts[t]) continue;
+    size_t len = strlen(texts[t]), word_len = strlen(word);
+    for (size_t i = 0; i + word_len <= len; ++i) {
+      size_t j = 0;
+      while (j < word_len && fold_ascii(texts[t][i + j]) == fold_ascii(word[j])) j += 1;
+      if (j == word_len) return true;
+    }
+  }
+  return false;
+}
+
+// Every query with what it has to match, worked out from the stats and fields directly
+typedef bool (*Test_Filter_Expect)(const Game *game, const Game_Stats *stats, const Test_Filter_Game *g);
+
+static bool expect_tag_coop(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) { (void)game; (void)s; return g->tags[0]; }
+static bool expect_not_tag_coop(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) { (void)game; (void)s; return !g->tags[0]; }
+static bool expect_nothing(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) { (void)game; (void)s; (void)g; return false; }
+static bool expect_everything(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) { (void)game; (void)s; (void)g; return true; }
+static bool expect_size_over_10m(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  (void)game; (void)g;
+  return s->size > 0 && s->size > 10ull << 20;
+}
+static bool expect_size_1gib_at_most(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  (void)game; (void)g;
+  return s->size > 0 && s->size <= 1ull << 30;
+}
+static bool expect_playtime_2h(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  (void)game; (void)g;
+  return s->playtime >= 2*60*60;
+}
+static bool expect_launches_3(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  (void)game; (void)g;
+  return s->launches == 3;
+}
+static bool expect_played_30d(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  (void)game; (void)g;
+  return s->launches > 0 && s->last_launch > TEST_FILTER_NOW - 30*TEST_FILTER_DAY;
+}
+static bool expect_not_played_30d(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  return !expect_played_30d(game, s, g);
+}
+static bool expect_added_1y(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  (void)game; (void)g;
+  return s->added != 0 && s->added < TEST_FILTER_NOW - 365*TEST_FILTER_DAY;
+}
+static bool expect_rating_8(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  (void)game; (void)s;
+  return g->rating >= 8;
+}
+static bool expect_rating_7(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  (void)game; (void)s;
+  return g->rating == 7;
+}
+static bool expect_rating_great(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  (void)game; (void)s;
+  return g->rating_text && streq(g->rating_text, "great");
+}
+static bool expect_genre_horror(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  (void)game; (void)s;
+  return g->genre && streq(g->genre, "horror");
+}
+static bool expect_not_genre_horror(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  return !expect_genre_horror(game, s, g);
+}
+static bool expect_re_zero(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  (void)s; (void)g;
+  return test_filter_has_text(game, "re:zero");
+}
+static bool expect_coop_dragon(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  (void)s;
+  return g->tags[0] && test_filter_has_text(game, "dragon");
+}
+static bool expect_mixed(const Game *game, const Game_Stats *s, const Test_Filter_Game *g) {
+  return expect_size_over_10m(game, s, g) && g->rating >= 5 && !g->tags[1] && test_filter_has_text(game, "quest");
+}
+
+static const struct {
+  const char *query;
+  Test_Filter_Expect expect;
+} test_filter_queries[] = {
+  { "tag:coop", expect_tag_coop },
+  { "-tag:coop", expect_not_tag_coop },
+  { "TAG:Coop", expect_tag_coop },
+  { "tag:nosuch", expect_nothing },
+  { "-tag:nosuch", expect_everything },
+  { "size>10M", expect_size_over_10m },
+  { "size<=1GiB", expect_size_1gib_at_most },
+  { "playtime>=2h", expect_playtime_2h },
+  { "launches=3", expect_launches_3 },
+  { "played<30d", expect_played_30d },
+  { "-played<30d", expect_not_played_30d },
+  { "added>1y", expect_added_1y },
+  { "rating>=8", expect_rating_8 },
+  { "rating:7", expect_rating_7 },
+  { "rating:great", expect_rating_great },
+  { "rating:nosuch", expect_nothing },
+  { "size>10parsecs", expect_nothing },
+  { "genre:horror", expect_genre_horror },
+  { "-genre:horror", expect_not_genre_horror },
+  { "re:zero", expect_re_zero },
+  { "tag:coop dragon", expect_coop_dragon },
+  { "size>10M rating>=5 -tag:rpg quest", expect_mixed },
+};
+
+// Units of filter_parse_number, then every query against the brute force over a catalog, in the order of a few sort
+// modes
+void test_filter(Test *test) {
+  static const struct {
+    const char *text;
+    Filter_Unit unit;
+    bool ok;
+    double number;
+  } numbers[] = {
+    { "10", FILTER_UNIT_NONE, true, 10 },
+    { "2.5", FILTER_UNIT_BYTES, true, 2.5 },
+    { "10k", FILTER_UNIT_BYTES, true, 10*1024.0 },
+    { "10G", FILTER_UNIT_BYTES, true, 10*1024.0*1024*1024 },
+    { "10GB", FILTER_UNIT_BYTES, true, 10*1024.0*1024*1024 },
+    { "10gib", FILTER_UNIT_BYTES, true, 10*1024.0*1024*1024 },
+    { "1T", FILTER_UNIT_BYTES, true, 1024.0*1024*1024*1024 },
+    { "10x", FILTER_UNIT_BYTES, false, 0 },
+    { "10GBs", FILTER_UNIT_BYTES, false, 0 },
+    { "90s", FILTER_UNIT_SECONDS, true, 90 },
+    { "5m", FILTER_UNIT_SECONDS, true, 5*60 },
+    { "2h", FILTER_UNIT_SECONDS, true, 2*60*60 },
+    { "30d", FILTER_UNIT_SECONDS, true, 30*24*60*60 },
+    { "2w", FILTER_UNIT_SECONDS, true, 14*24*60*60 },
+    { "1y", FILTER_UNIT_SECONDS, true, 365*24*60*60 },
+    { "1dd", FILTER_UNIT_SECONDS, false, 0 },
+    { "10G", FILTER_UNIT_NONE, false, 0 },
+    { "", FILTER_UNIT_NONE, false, 0 },
+    { "G", FILTER_UNIT_BYTES, false, 0 },
+  };
+  for (size_t i = 0; i < NOB_ARRAY_LEN(numbers); ++i) {
+    double number = 0;
+    bool ok = filter_parse_number(nob_sv_from_cstr(numbers[i].text), numbers[i].unit, &number);
+    TEST_CHECK(test, ok == numbers[i].ok && (!ok || number == numbers[i].number), "\"%s\" parsed %d to %g",
+               numbers[i].text, ok, number);
+  }
+
+  Games games = {0};
+  Library lib = {0};
+  Test_Filter_Game *expect = test_filter_library(&games, &lib, 5000, 9);
+  Search search = {0};
+  search_sync(&search, &games);
+  static const Sort_Mode sorts[] = { SORT_NAME, SORT_PLAYTIME, SORT_LAST_PLAYED };
+  Filter filter = {0};
+  Game_Indices want = {0};
+  for (size_t s = 0; s < NOB_ARRAY_LEN(sorts); ++s) {
+    lib.sort = sorts[s];
+    for (size_t q = 0; q < NOB_ARRAY_LEN(test_filter_queries); ++q) {
+      filter.query.count = 0;
+      nob_sb_append_cstr(&filter.query, test_filter_queries[q].query);
+      filter_compile(&filter, &lib.meta, TEST_FILTER_NOW);
+      filter_run(&filter, &search, &lib);
+      want.count = 0;
+      const Game_Indices *order = &lib.orders[lib.sort];
+      for (size_t i = 0; i < order->count; ++i) {
+        size_t index = order->items[i];
+        if (test_filter_queries[q].expect(&games.items[index], &lib.stats.items[index], &expect[index])) {
+          nob_da_append(&want, index);
+        }
+      }
+      TEST_CHECK(test, filter.hits.count == want.count
+                 && memcmp(filter.hits.items, want.items, sizeof(*want.items)*want.count) == 0,
+                 "\"%s\" sorted by %d: %zu hits, %zu expected", test_filter_queries[q].query, (int)lib.sort,
+                 filter.hits.count, want.count);
+    }
+  }
+
+  free(want.items);
+  filter_free(&filter);
+  search_free(&search);
+  library_free(&lib);
+  free(games.items);
+  free(expect);
+}
+
+// Counts the non overlapping times needle shows up in text
+size_t test_count_cstr(const char *text, size_t len, const char *needle) {
+  size_t count = 0, needle_len = strlen(needle);
+  for (size_t i = 0; i + needle_len <= len; ++i) {
+    if (memcmp(text + i, needle, needle_len) == 0) {
+      count += 1;
+      i += needle_len - 1;
+    }
+  }
+  return count;
+}
+
+// Records of games in the catalog land on their stats, the ones of games that went away keep one orphan section
+// per key with the newest value of each field, and a record cut short at the end is dropped
+void test_journal_replay(Test *test) {
+  Games games = {0};
+  Library lib = {0};
+  test_library_catalog(&games, &lib, TEST_LIBRARY_GAMES);
+  nob_sb_append_cstr(&lib.orphans, "\n[gone/run.sh]\nadded = 1\nplaytime = 5\n");
+  Nob_String_Builder journal = {0};
+  Library_Journal_Header header = { .magic = LIBRARY_JOURNAL_MAGIC, .version = LIBRARY_JOURNAL_VERSION };
+  nob_sb_append_buf(&journal, (const char *)&header, sizeof(header));
+  for (int64_t i = 1; i <= 50; ++i) {
+    journal_append_record(&journal, JOURNAL_PLAYTIME, lib.keys.items[3], &i, sizeof(i));
+    journal_append_record(&journal, JOURNAL_PLAYTIME, "gone/run.sh", &i, sizeof(i));
+    journal_append_record(&journal, JOURNAL_PLAYTIME, "other/run.sh", &i, sizeof(i));
+  }
+  Journal_Launch launch = { .launches = 2, .last_launch = 1700000000, .frecency = 1.5 };
+  journal_append_record(&journal, JOURNAL_LAUNCH, "gone/run.sh", &launch, sizeof(launch));
+  journal_append_record(&journal, JOURNAL_ALIAS, lib.keys.items[4], "Renamed", 8);
+  size_t good_size = journal.count;
+  journal_append_record(&journal, JOURNAL_PLAYTIME, lib.keys.items[5], &good_size, sizeof(int64_t));
+  journal.count -= 3;
+  const char *path = strdup(test_temp_path("replay" LIBRARY_JOURNAL_FILE));
+  TEST_CHECK(test, nob_write_entire_file(path, journal.items, journal.count), "could not write %s", path);
+
+  bool aliased = false, replayed = false;
+  size_t good = library_replay_journal(&lib, path, &games, &aliased, &replayed);
+  TEST_CHECK(test, good == good_size, "replayed %zu bytes of %zu good ones", good, good_size);
+  TEST_CHECK(test, replayed && aliased, "replayed %d, aliased %d", replayed, aliased);
+  TEST_CHECK(test, lib.stats.items[3].playtime == 50, "playtime of game 3 is %lld", (long long)lib.stats.items[3].playtime);
+  TEST_CHECK(test, lib.stats.items[5].playtime == 0, "the record cut short was replayed");
+  TEST_CHECK(test, games.items[4].alias && streq(games.items[4].alias, "Renamed"), "alias of game 4 not set");
+  const char *orphans = lib.orphans.items;
+  size_t len = lib.orphans.count;
+  TEST_CHECK(test, test_count_cstr(orphans, len, "[gone/run.sh]") == 1, "gone has more than one section");
+  TEST_CHECK(test, test_count_cstr(orphans, len, "[other/run.sh]") == 1, "other has more than one section");
+  TEST_CHECK(test, test_count_cstr(orphans, len, "playtime = ") == 2, "%zu playtime fields",
+             test_count_cstr(orphans, len, "playtime = "));
+  TEST_CHECK(test, test_count_cstr(orphans, len, "playtime = 50\n") == 2, "orphans did not keep the newest playtime");
+  TEST_CHECK(test, test_count_cstr(orphans, len, "added = 1\n") == 1 && test_count_cstr(orphans, len, "launches = 2\n") == 1,
+             "fields the journal did not change were lost:\n%.*s", (int)len, orphans);
+
+  remove(path);
+  free((char *)path);
+  free(journal.items);
+  library_free(&lib);
+  free(games.items);
+}
+
+// A permutation that another build sorted by its own rules loads, but gets sorted again before anything moves a game
+// in it
+void test_library_foreign_order(Test *test) {
+  Games games = {0}, got_games = {0};
+  Library lib = {0}, got = {0};
+  test_library_catalog(&games, &lib, TEST_LIBRARY_GAMES);
+  test_library_fill(&games, &lib);
+  const char *text_path = strdup(test_temp_path("foreign.lzua"));
+  const char *path = strdup(test_temp_path("foreign.lzua.bin"));
+  const char *journal_path = strdup(test_temp_path("foreign" LIBRARY_JOURNAL_FILE));
+  remove(text_path);
+  remove(journal_path);
+  TEST_CHECK(test, library_save_binary(&lib, path, &games), "could not save %s", path);
+  Nob_String_Builder file = {0};
+  TEST_CHECK(test, nob_read_entire_file(path, &file), "could not read %s back", path);
+
+  bool swapped = false;
+  for (size_t at = sizeof(Library_File_Header); at + sizeof(Library_File_Section) <= file.count;) {
+    Library_File_Section section = {0};
+    memcpy(&section, file.items + at, sizeof(section));
+    char *payload = file.items + at + sizeof(section);
+    Library_File_Order order = {0};
+    if (section.tag == LIBRARY_SECTION_ORDER) memcpy(&order, payload, sizeof(order));
+    if (section.tag == LIBRARY_SECTION_ORDER && order.mode == SORT_PLAYTIME && order.count >= 2) {
+      uint32_t *indices = (uint32_t *)(payload + sizeof(order));
+      uint32_t first = indices[0];
+      indices[0] = indices[1];
+      indices[1] = first;
+      swapped = true;
+    }
+    at += sizeof(section) + LIBRARY_SECTION_ALIGN((size_t)section.size);
+  }
+  TEST_CHECK(test, swapped, "no playtime order in %s", path);
+  test_library_reseal(&file);
+  TEST_CHECK(test, nob_write_entire_file(path, file.items, file.count), "could not write %s", path);
+
+  test_library_catalog(&got_games, &got, TEST_LIBRARY_GAMES);
+  TEST_CHECK(test, library_load(&got, text_path, path, journal_path, &got_games), "could not load %s", path);
+  TEST_CHECK(test, library_orders_sorted(&got), "the orders of the other build were kept");
+  size_t index = got.orders[SORT_PLAYTIME].items[0];
+  Library_Change change = { .index = index, .stats = got.stats.items[index], .alias = got_games.items[index].alias };
+  change.stats.playtime = 0;
+  library_apply_change(&got, &got_games, &change);
+  TEST_CHECK(test, library_orders_sorted(&got), "the orders are not sorted after a change");
+  TEST_CHECK(test, got.orders[SORT_PLAYTIME].items[got_games.count - 1] == index, "the game did not move to the end");
+
+  remove(path);
+  remove(text_path);
+  free(file.items);
+  library_free(&got);
+  free(got_games.items);
+  library_free(&lib);
+  free(games.items);
+  free((char *)text_path);
+  free((char *)path);
+  free((char *)journal_path);
+}
+
+// Enough of a persister to call persister_write on without its thread, as a second instance would have one
+void test_persister_init(Persister *persister, const Library *lib, const Games *games, const char **paths) {
+  *persister = (Persister) { .path = paths[0], .binary_path = paths[1], .journal_path = paths[2] };
+  library_copy(&persister->mirror, &persister->games, lib, games);
+  persister->mirror.games = &persister->games;
+}
+
+void test_persister_playtime(Persister *persister, size_t index, int64_t playtime, bool compact) {
+  Library_Changes changes = {0};
+  Library_Change change = { .index = index, .stats = persister->mirror.stats.items[index], .alias = persister->games.items[index].alias };
+  change.stats.playtime = playtime;
+  nob_da_append(&changes, change);
+  persister_write(persister, &changes, compact);
+  free(changes.items);
+}
+
+// Two instances on the same games directory take turns appending to the journal, one of them compacts it while the
+// other still thinks it is as long as it last saw, and loading afterwards has every change of both
+void test_journal_shared(Test *test) {
+  const char *paths[3] = {
+    strdup(test_temp_path("shared.lzua")),
+    strdup(test_temp_path("shared.lzua.bin")),
+    strdup(test_temp_path("shared" LIBRARY_JOURNAL_FILE)),
+  };
+  for (size_t i = 0; i < NOB_ARRAY_LEN(paths); ++i) remove(paths[i]);
+  Games games = {0};
+  Library lib = {0};
+  test_library_catalog(&games, &lib, TEST_LIBRARY_GAMES);
+  Persister a = {0}, b = {0};
+  test_persister_init(&a, &lib, &games, paths);
+  test_persister_init(&b, &lib, &games, paths);
+
+  test_persister_playtime(&a, 1, 10, false);
+  test_persister_playtime(&b, 2, 20, false);
+  test_persister_playtime(&a, 3, 30, true);
+  TEST_CHECK(test, a.journal_size == 0, "compacting left %zu bytes of journal", a.journal_size);
+  TEST_CHECK(test, a.mirror.stats.items[2].playtime == 20, "compacting did not take what the other one appended");
+  test_persister_playtime(&b, 4, 40, false);
+  test_persister_playtime(&a, 5, 50, false);
+
+  Games loaded_games = {0};
+  Library loaded = {0};
+  test_library_catalog(&loaded_games, &loaded, TEST_LIBRARY_GAMES);
+  TEST_CHECK(test, library_load(&loaded, paths[0], paths[1], paths[2], &loaded_games), "could not load %s", paths[0]);
+  for (size_t i = 1; i <= 5; ++i) {
+    TEST_CHECK(test, loaded.stats.items[i].playtime == (int64_t)i*10, "playtime of game %zu is %lld", i,
+               (long long)loaded.stats.items[i].playtime);
+  }
+  Nob_String_Builder journal = {0};
+  TEST_CHECK(test, nob_read_entire_file(paths[2], &journal), "could not read %s", paths[2]);
+  TEST_CHECK(test, loaded.journal_size == journal.count, "%zu of the %zu bytes of the journal are good",
+             loaded.journal_size, journal.count);
+
+  free(journal.items);
+  library_free(&loaded);
+  free(loaded_games.items);
+  library_free(&a.mirror);
+  free(a.games.items);
+  library_free(&b.mirror);
+  free(b.games.items);
+  library_free(&lib);
+  free(games.items);
+  for (size_t i = 0; i < NOB_ARRAY_LEN(paths); ++i) {
+    remove(paths[i]);
+    free((char *)paths[i]);
+  }
+}
+
+#define SUBSTRING_BENCH_SIZE (64*1024*1024)
+#define BENCH_RUNS 5
+
+// Best of a few runs over a haystack the needle is not in, so every kernel reads all of it
+void bench_substring_kernels(void) {
+  Substring_Kernel kernels[3];
+  size_t kernel_count = substring_kernels(kernels);
+  char *hay = malloc(SUBSTRING_BENCH_SIZE + SUBSTRING_PADDING);
+  NOB_ASSERT(hay != NULL && "Buy more RAM lol");
+  uint64_t rng = 1;
+  for (size_t i = 0; i < SUBSTRING_BENCH_SIZE + SUBSTRING_PADDING; ++i) hay[i] = 'a' + test_random(&rng)%26;
+  static const size_t needle_lens[] = { 1, 2, 4, 8, 16, 33 };
+  for (size_t n = 0; n < NOB_ARRAY_LEN(needle_lens); ++n) {
+    char needle[64];
+    memset(needle, '#', needle_lens[n]);
+    for (size_t k = 0; k < kernel_count; ++k) {
+      uint64_t best = UINT64_MAX;
+      for (int run = 0; run < BENCH_RUNS; ++run) {
+        uint64_t started = nob_nanos_since_unspecified_epoch();
+        size_t found = kernels[k].find(hay, SUBSTRING_BENCH_SIZE, needle, needle_lens[n]);
+        uint64_t took = nob_nanos_since_unspecified_epoch() - started;
+        NOB_ASSERT(found == SUBSTRING_NOT_FOUND);
+        best = MIN(best, took);
+      }
+      nob_log(NOB_INFO, "substring %-6s needle %2zu: %6.2f GB/s", kernels[k].name, needle_lens[n],
+              SUBSTRING_BENCH_SIZE/(double)best);
+    }
+  }
+  free(hay);
+}
+
+#define SEARCH_BENCH_GAMES 50000
+
+// Typing a few queries a key at a time over a 50k catalog and backspacing them away, best of a few runs per key
+void bench_search(void) {
+  Games games = test_search_catalog(SEARCH_BENCH_GAMES, 1);
+  Search search = {0};
+  search_sync(&search, &games);
+  static const char *queries[] = { "dragon", "sdq", "hollow knight", "zzz", "'quest" };
+  for (size_t q = 0; q < NOB_ARRAY_LEN(queries); ++q) {
+    size_t len = strlen(queries[q]);
+    uint64_t worst_key = 0, worst_backspace = 0, first_key = 0;
+    for (size_t i = 0; i < len; ++i) {
+      uint64_t best = UINT64_MAX;
+      for (int run = 0; run < BENCH_RUNS; ++run) {
+        uint64_t started = nob_nanos_since_unspecified_epoch();
+        search_append(&search, &games, &queries[q][i], 1);
+        best = MIN(best, nob_nanos_since_unspecified_epoch() - started);
+        if (run + 1 < BENCH_RUNS) search_pop(&search);
+      }
+      if (i == 0) first_key = best;
+      else worst_key = MAX(worst_key, best);
+    }
+    size_t results = search_view(&search).count;
+    while (search.depth > 0) {
+      uint64_t started = nob_nanos_since_unspecified_epoch();
+      search_pop(&search);
+      worst_backspace = MAX(worst_backspace, nob_nanos_since_unspecified_epoch() - started);
+    }
+    nob_log(NOB_INFO, "search %-15s %5zu results: first key %.3fms, worst later key %.3fms, worst backspace %.3fms",
+            nob_temp_sprintf("\"%s\"", queries[q]), results, first_key/1e6, worst_key/1e6, worst_backspace/1e6);
+  }
+  search_free(&search);
+  free(games.items);
+}
+
+// Packing alone from 1k to 1M tiles of random widths in 1900px wide bounds. ns per tile staying flat is what linear
+// looks like, the rows are appended to a list that keeps its buffer between runs like the layout's does
+void bench_pack(void) {
+  static const size_t sizes[] = { 1000, 10000, 100000, 1000000 };
+  size_t most = sizes[NOB_ARRAY_LEN(sizes) - 1];
+  GameButton *buttons = calloc(most, sizeof(*buttons));
+  NOB_ASSERT(buttons != NULL && "Buy more RAM lol");
+  uint64_t rng = 13;
+  for (size_t i = 0; i < most; ++i) {
+    buttons[i].width = MAX(GAME_BUTTON_HEIGHT, (float)(40 + test_random(&rng)%400) + GENERAL_PADDING*2);
+    buttons[i].height = GAME_BUTTON_HEIGHT;
+  }
+  Rectangle bounds = { 0, 0, 1900, 1000 };
+  Layout_Rows rows = {0};
+  for (size_t s = 0; s < NOB_ARRAY_LEN(sizes); ++s) {
+    uint64_t best = UINT64_MAX;
+    for (int run = 0; run < BENCH_RUNS; ++run) {
+      uint64_t started = nob_nanos_since_unspecified_epoch();
+      pack_game_buttons_rows(bounds, buttons, sizes[s], &rows);
+      best = MIN(best, nob_nanos_since_unspecified_epoch() - started);
+    }
+    nob_log(NOB_INFO, "pack %7zu tiles in %6zu rows: %8.3fms, %.1f ns/tile", sizes[s], rows.count, best/1e6,
+            (double)best/sizes[s]);
+  }
+  free(rows.items);
+  free(buttons);
+}
+
+// Enough of a font for MeasureTextEx, which only reads the glyphs when there is no window. The texture id just has to
+// be one that is not the default font
+Font bench_font(void) {
+  Font font = { .baseSize = GAME_BUTTON_FONT_SIZE, .glyphCount = 95, .texture = { .id = 1 } };
+  font.glyphs = calloc(font.glyphCount, sizeof(*font.glyphs));
+  font.recs = calloc(font.glyphCount, sizeof(*font.recs));
+  NOB_ASSERT(font.glyphs != NULL && font.recs != NULL && "Buy more RAM lol");
+  for (int i = 0; i < font.glyphCount; ++i) {
+    font.glyphs[i] = (GlyphInfo) { .value = 32 + i, .advanceX = 8 + i%5 };
+    font.recs[i] = (Rectangle) { .width = (float)(8 + i%5), .height = GAME_BUTTON_FONT_SIZE };
+  }
+  return font;
+}
+
+// Frames of a window that does not change against ones after a resize, where the titles are measured already, and
+// ones after a font change, which measure every title again like every frame did before the layout was cached
+void bench_layout(void) {
+  static const size_t sizes[] = { 1000, 10000, 100000 };
+  Font fonts[2] = { bench_font(), bench_font() };
+  fonts[1].texture.id = 2;
+  for (size_t s = 0; s < NOB_ARRAY_LEN(sizes); ++s) {
+    Games games = test_search_catalog(sizes[s], 11);
+    Layout layout = {0};
+    Rectangle bounds = { 0, 0, 1280, 720 };
+    layout_update(&layout, bounds, games, (Game_View) {0}, fonts[0], GAME_BUTTON_FONT_SIZE);
+    uint64_t best[3] = { UINT64_MAX, UINT64_MAX, UINT64_MAX };
+    for (int run = 0; run < BENCH_RUNS; ++run) {
+      uint64_t started = nob_nanos_since_unspecified_epoch();
+      NOB_ASSERT(!layout_update(&layout, bounds, games, (Game_View) {0}, fonts[run%2], GAME_BUTTON_FONT_SIZE));
+      best[0] = MIN(best[0], nob_nanos_since_unspecified_epoch() - started);
+
+      bounds.width += run%2 ? -100 : 100;
+      started = nob_nanos_since_unspecified_epoch();
+      NOB_ASSERT(layout_update(&layout, bounds, games, (Game_View) {0}, fonts[run%2], GAME_BUTTON_FONT_SIZE));
+      best[1] = MIN(best[1], nob_nanos_since_unspecified_epoch() - started);
+
+      started = nob_nanos_since_unspecified_epoch();
+      NOB_ASSERT(layout_update(&layout, bounds, games, (Game_View) {0}, fonts[(run + 1)%2], GAME_BUTTON_FONT_SIZE));
+      best[2] = MIN(best[2], nob_nanos_since_unspecified_epoch() - started);
+    }
+    nob_log(NOB_INFO, "layout %6zu games: unchanged %.4fms, resized %.3fms, font changed %.3fms", sizes[s],
+            best[0]/1e6, best[1]/1e6, best[2]/1e6);
+    free(layout.items);
+    free(layout.rows.items);
+    free(layout.measures.items);
+    free(layout.links.items);
+    free(games.items);
+  }
+  for (size_t i = 0; i < NOB_ARRAY_LEN(fonts); ++i) {
+    free(fonts[i].glyphs);
+    free(fonts[i].recs);
+  }
+}
+
+#define FILTER_BENCH_GAMES 100000
+
+// Building the columns and then compiling and running every filter test query over a 100k catalog, best of a few
+// runs per query
+void bench_filter(void) {
+  Games games = {0};
+  Library lib = {0};
+  free(test_filter_library(&games, &lib, FILTER_BENCH_GAMES, 2));
+  Search search = {0};
+  search_sync(&search, &games);
+  uint64_t best = UINT64_MAX;
+  for (int run = 0; run < BENCH_RUNS; ++run) {
+    uint64_t started = nob_nanos_since_unspecified_epoch();
+    library_meta_build(&lib.meta, &lib);
+    best = MIN(best, nob_nanos_since_unspecified_epoch() - started);
+  }
+  nob_log(NOB_INFO, "filter columns of %d games: %.3fms", FILTER_BENCH_GAMES, best/1e6);
+
+  Filter filter = {0};
+  for (size_t q = 0; q < NOB_ARRAY_LEN(test_filter_queries); ++q) {
+    best = UINT64_MAX;
+    for (int run = 0; run < BENCH_RUNS; ++run) {
+      uint64_t started = nob_nanos_since_unspecified_epoch();
+      filter.query.count = 0;
+      nob_sb_append_cstr(&filter.query, test_filter_queries[q].query);
+      filter_compile(&filter, &lib.meta, TEST_FILTER_NOW);
+      filter_run(&filter, &search, &lib);
+      best = MIN(best, nob_nanos_since_unspecified_epoch() - started);
+    }
+    nob_log(NOB_INFO, "filter %-36s %6zu hits: %.3fms", nob_temp_sprintf("\"%s\"", test_filter_queries[q].query),
+            filter.hits.count, best/1e6);
+  }
+  filter_free(&filter);
+  search_free(&search);
+  library_free(&lib);
+  free(games.items);
+}
+
+#define JOURNAL_BENCH_GAMES 10000
+#define JOURNAL_BENCH_RECORDS 1000000
+
+// Replaying a journal of a million records of every kind over a 10k catalog, one in twenty of them for games that
+// went away so the orphans get their share
+void bench_journal_replay(void) {
+  Games games = {0};
+  Library lib = {0};
+  test_library_catalog(&games, &lib, JOURNAL_BENCH_GAMES);
+  Nob_String_Builder journal = {0};
+  Library_Journal_Header header = { .magic = LIBRARY_JOURNAL_MAGIC, .version = LIBRARY_JOURNAL_VERSION };
+  nob_sb_append_buf(&journal, (const char *)&header, sizeof(header));
+  uint64_t rng = 5;
+  for (size_t i = 0; i < JOURNAL_BENCH_RECORDS; ++i) {
+    uint64_t r = test_random(&rng);
+    const char *key = r%20 == 0 ? nob_temp_sprintf("gone%d/run.sh", (int)(r/20%500)) : lib.keys.items[r/20%games.count];
+    int64_t value = (int64_t)i;
+    switch (r/20/games.count%8) {
+      case 0: case 1: case 2: case 3:
+        journal_append_record(&journal, JOURNAL_PLAYTIME, key, &value, sizeof(value));
+        break;
+      case 4: case 5: {
+        Journal_Launch launch = { .launches = (uint32_t)i, .last_launch = value, .frecency = i*0.5 };
+        journal_append_record(&journal, JOURNAL_LAUNCH, key, &launch, sizeof(launch));
+      } break;
+      case 6: {
+        Journal_Size size = { .size = i*4096, .size_mtime = value };
+        journal_append_record(&journal, JOURNAL_SIZE, key, &size, sizeof(size));
+      } break;
+      default:
+        journal_append_record(&journal, JOURNAL_ALIAS, key, i%2 ? "Renamed" : "", i%2 ? 8 : 1);
+    }
+    nob_temp_reset();
+  }
+  const char *path = strdup(test_temp_path("bench" LIBRARY_JOURNAL_FILE));
+  NOB_ASSERT(nob_write_entire_file(path, journal.items, journal.count));
+  library_free(&lib);
+  free(games.items);
+
+  uint64_t best = UINT64_MAX;
+  for (int run = 0; run < BENCH_RUNS; ++run) {
+    test_library_catalog(&games, &lib, JOURNAL_BENCH_GAMES);
+    bool aliased = false, replayed = false;
+    uint64_t started = nob_nanos_since_unspecified_epoch();
+    size_t good = library_replay_journal(&lib, path, &games, &aliased, &replayed);
+    best = MIN(best, nob_nanos_since_unspecified_epoch() - started);
+    NOB_ASSERT(good == journal.count);
+    library_free(&lib);
+    free(games.items);
+  }
+  nob_log(NOB_INFO, "journal replay: %d records, %.1f MiB, over %d games: %.1fms", JOURNAL_BENCH_RECORDS,
+          journal.count/(1024.0*1024.0), JOURNAL_BENCH_GAMES, best/1e6);
+  remove(path);
+  free((char *)path);
+  free(journal.items);
+}
+
+static const struct {
+  const char *name;
+  Test_Func func;
+} tests[] = {
+  { "substring_kernels", test_substring_kernels },
+  { "library_binary", test_library_binary },
+  { "library_foreign_order", test_library_foreign_order },
+  { "search_incremental", test_search_incremental },
+  { "filter", test_filter },
+  { "journal_replay", test_journal_replay },
+  { "journal_shared", test_journal_shared },
+};
+
+static const struct {
+  const char *name;
+  Bench_Func func;
+} benches[] = {
+  { "substring_kernels", bench_substring_kernels },
+  { "search", bench_search },
+  { "filter", bench_filter },
+  { "journal_replay", bench_journal_replay },
+  { "pack", bench_pack },
+  { "layout", bench_layout },
+};
+
+// Runs whatever has a name containing filter, everything without one
+int tests_main(int argc, const char **argv) {
+  const char *mode = nob_shift(argv, argc);
+  const char *filter = argc > 0 ? nob_shift(argv, argc) : "";
+  if (streq(mode, "--bench")) {
+    for (size_t i = 0; i < NOB_ARRAY_LEN(benches); ++i) {
+      if (strstr(benches[i].name, filter)) benches[i].func();
+    }
+    return 0;
+  }
+
+  size_t failed = 0;
+  for (size_t i = 0; i < NOB_ARRAY_LEN(tests); ++i) {
+    if (!strstr(tests[i].name, filter)) continue;
+    Test test = { .name = tests[i].name };
+    uint64_t started = nob_nanos_since_unspecified_epoch();
+    tests[i].func(&test);
+    double ms = (nob_nanos_since_unspecified_epoch() - started)/1e6;
+    nob_log(test.failures ? NOB_ERROR : NOB_INFO, "%s %s: %zu checks, %zu failed (%.1fms)",
+            test.failures ? "FAIL" : "ok", test.name, test.checks, test.failures, ms);
+    if (test.failures) failed += 1;
+  }
+  return failed > 0;
+}
+#endif // LZUA_TESTS
+
+
+int main(int argc, const char **argv) {
+  const char *program = nob_shift(argv, argc);
+  (void) program;
+
+  #if LZUA_TESTS
+  if (argc > 0 && (streq(argv[0], "--test") || streq(argv[0], "--bench"))) return tests_main(argc, argv);
+  #endif // LZUA_TESTS
+
+  const char *games_dir = NULL;
+  bool resident_mode = false;
+  bool quit_resident = false;
+  const char *launch_title = NULL;
+  while (argc > 0) {
+    const char *arg = nob_shift(argv, argc);
+    if (arg[0] != '-' && !games_dir) {
+      games_dir = arg;
+      continue;
+    }
+    if (streq(arg, "--resident")) {
+      resident_mode = true;
+      continue;
+    }
+    if (streq(arg, "--quit")) {
+      quit_resident = true;
+      continue;
+    }
+    if (streq(arg, "--launch")) {
+      if (argc == 0) {
+        nob_log(NOB_ERROR, "--launch needs the title of a game");
+        usage(program);
+        return 1;
+      }
+      launch_title = nob_shift(argv, argc);
+      continue;
+    }
+
+    if (arg[0] == '-') {
+      nob_log(NOB_ERROR, "Unknown flag passed: %s", arg);
+      usage(program);
+    } else {
+      nob_log(NOB_ERROR, "Unknown command passed: %s", arg);
+      usage(program);
+    }
+    return 1;
+  }
+
+  const char *home_dir = get_home_path();
+  if (!home_dir) {
+    nob_log(NOB_ERROR, "Failed to get the home path from the environment. Cannot load custom configs");
+    return 1;
+  }
+
+  const char *cache_dir = get_cache_path(home_dir);
+  if (!cache_dir) {
+    nob_log(NOB_WARNING, "Could not create a cache directory, thumbnails won't be kept between runs");
+  }
+
+  // A resident lzua already has everything loaded, all that is left for us is to pass the request on
+  char *socket_path = resident_socket_path(cache_dir);
+  if (socket_path) {
+    const char *request = "show";
+    if (quit_resident) request = "quit";
+    else if (launch_title) request = nob_temp_sprintf("launch %s", launch_title);
+    if (resident_send(socket_path, request)) return 0;
+  }
+  if (quit_resident) {
+    nob_log(NOB_INFO, "There is no resident lzua to quit");
+    return 0;
+  }
+
+  if (!games_dir) {
+    games_dir = DEFAULT_DIRECTORY;
+    if (!games_dir) {
+      nob_log(NOB_ERROR, "Must pass in the folder of the folders of executables");
+      return 1;
+    } else {
+      nob_log(NOB_INFO, "Loading default dir: %s\n", games_dir);
+    }
+  }
+
+  Nob_Cmd cmd = {0};
+  Nob_Procs processes = {
+    .items = malloc(sizeof(Nob_Proc)), // In theory there shouldn't be more than one
+    .capacity = 1,
+    .count = 0,
   };
   Games games = {0};
+  // Installing or removing a game touches the folder, a resident lzua looks at it again before showing itself
+  int64_t games_dir_mtime = folder_mtime(games_dir);
   if (!read_games_dir(games_dir, &games)) return 1;
-  GameButton *buttons = nob_temp_alloc(sizeof(GameButton)*games.count);
+  Layout layout = {0};
+  Layout recent_layout = {0};
+  Focus focus = { .game = NAV_NONE, .position = NAV_NONE };
+  // What is running right now and since when, for the playtime
+  size_t running_game = SIZE_MAX;
+  int64_t running_since = 0;
+
+  char *trigrams_path = strdup(nob_temp_sprintf("%s%c%s", games_dir, PATH_DELIM, TRIGRAMS_FILE));
+  Trigram_Index trigrams = {0};
+  uint64_t indexing_started = nob_nanos_since_unspecified_epoch();
+  bool trigrams_loaded = trigram_index_load(&trigrams, trigrams_path);
+  trigram_index_sync(&trigrams, &games);
+  nob_log(NOB_INFO, "Trigram index ready in %.2fms (%s)", (nob_nanos_since_unspecified_epoch() - indexing_started)/1e6,
+          trigrams_loaded ? "loaded" : "built");
+  trigram_index_log_stats(&trigrams);
+
+  char *library_path = strdup(nob_temp_sprintf("%s%c%s", games_dir, PATH_DELIM, LIBRARY_FILE));
+  char *library_binary_path = strdup(nob_temp_sprintf("%s%c%s", games_dir, PATH_DELIM, LIBRARY_BINARY_FILE));
+  char *library_journal_path = strdup(nob_temp_sprintf("%s%c%s", games_dir, PATH_DELIM, LIBRARY_JOURNAL_FILE));
+  uint64_t library_started = nob_nanos_since_unspecified_epoch();
+  Library library = {0};
+  if (!library_load(&library, library_path, library_binary_path, library_journal_path, &games)) {
+    nob_log(NOB_WARNING, "Could not read %s, starting without launch history", library_path);
+  }
+  nob_log(NOB_INFO, "Library ready in %.2fms", (nob_nanos_since_unspecified_epoch() - library_started)/1e6);
+  Disk_Walker walker = {0};
+  if (!disk_walker_start(&walker, &games, &library)) {
+    nob_log(NOB_WARNING, "Could not start measuring the games on disk");
+  }
+  Persister persister = {0};
+  persister_start(&persister, &library, &games, library_path, library_binary_path, library_journal_path);
+  bool tooltip_shown = false;
 
 
   SetConfigFlags(FLAG_WINDOW_RESIZABLE);
 
   SetTraceLogLevel(LOG_WARNING);
   InitWindow(WIDTH, HEIGHT, "Lzua");
+  set_window_title(library.sort);
   SetWindowMinSize(MIN_WIDTH, MIN_HEIGHT);
 
   nob_log(NOB_INFO, "Initialized window (%d, %d)", WIDTH, HEIGHT);
@@ -282,66 +7630,306 @@ int main(int argc, const char **argv) {
   MouseCursor cursor = MOUSE_CURSOR_DEFAULT;
   SetMouseCursor(MOUSE_CURSOR_DEFAULT);
 
-  while (!WindowShouldClose()) {
+  Ui_Font ui_font = {0};
+  ui_font_init(&ui_font, GAME_BUTTON_FONT_SIZE, cache_dir);
+  Scroll scroll = {0};
+  Render_Scheduler scheduler = {0};
+  render_scheduler_init(&scheduler);
+  Profiler prof = {0};
+  profiler_start(&prof);
+  Tile_Renderer tiles = {0};
+  // Without the shader the tiles go through the shapes fallback, the same as when it does not compile
+  if (!prof.no_tile_shader) tile_renderer_load(&tiles);
+  Art_Cache art = {0};
+  if (!art_init(&art, cache_dir)) return 1;
+  substring_select_kernel();
+  Search search = { .trigrams = &trigrams };
+  Filter filter = {0};
+  // Escape clears the search first, it only closes the window when there is nothing to clear
+  SetExitKey(KEY_NULL);
+  // Only listening once the window is up, the listener wakes the main loop through GLFW
+  Resident resident = {0};
+  resident_init(&resident);
+  if (resident_mode && !socket_path) {
+    nob_log(NOB_WARNING, "Nowhere to put the resident socket, running as a normal instance");
+  } else if (resident_mode) {
+    resident_listen(&resident, socket_path);
+  }
+  if (launch_title) resident_push(&resident, RESIDENT_LAUNCH, launch_title);
+
+  bool running = true;
+  while (running) {
+    if (!resident.hidden && (WindowShouldClose() || (IsKeyPressed(KEY_ESCAPE) && search.depth == 0))) {
+      if (!resident.listening) break;
+      // Everything stays loaded, the next lzua only has to show the window again
+      render_scheduler_suspend(&scheduler);
+      search_clear(&search);
+      scroll = (Scroll) {0};
+      SetWindowState(FLAG_WINDOW_HIDDEN);
+      resident.hidden = true;
+    }
+    if (profiler_update(&prof)) render_scheduler_invalidate(&scheduler);
+    trigram_index_sync(&trigrams, &games);
+    if (trigrams.dirty) {
+      trigrams.dirty = false;
+      if (!trigram_index_save(&trigrams, trigrams_path)) {
+        nob_log(NOB_WARNING, "Could not save the trigram index to %s", trigrams_path);
+      }
+    }
+    search_sync(&search, &games);
+    library_sync(&library, &games);
+    if (search_update(&search, &games)) {
+      scroll = (Scroll) {0};
+      render_scheduler_invalidate(&scheduler);
+    }
+    if (library_update(&library)) {
+      scroll = (Scroll) {0};
+      render_scheduler_invalidate(&scheduler);
+      set_window_title(library.sort);
+    }
+    if (focus_update(&focus, &layout)) render_scheduler_invalidate(&scheduler);
+
+    PROF_BEGIN(&prof, PROF_DRAIN);
     if (processes.count > 0) {
-      if (!nob_procs_wait_and_reset(&processes)) {
-        // I don't care if the game process stays a zombie, we don't crash ma boi
-        nob_log(NOB_ERROR, "Failure happened while waiting for item");
+      Proc_Status status = proc_poll(processes.items[0]);
+      if (status != PROC_RUNNING) {
+        if (status == PROC_FAILED) {
+          // I don't care if the game process stays a zombie, we don't crash ma boi
+          nob_log(NOB_ERROR, "Failure happened while waiting for item");
+        } else {
+          nob_log(NOB_INFO, "Succesfully closed out of game");
+        }
         processes.count = 0;
+        library_record_playtime(&library, running_game, (int64_t)time(NULL) - running_since);
+        render_scheduler_invalidate(&scheduler);
+      }
+    }
+
+    if (art_has_results(&art)) render_scheduler_invalidate(&scheduler);
+    disk_walker_set_paused(&walker, processes.count > 0);
+    if (disk_walker_drain(&walker, &library) > 0) {
+      if (library.sort == SORT_SIZE || tooltip_shown) render_scheduler_invalidate(&scheduler);
+    }
+    PROF_END(&prof, PROF_DRAIN);
+
+    // Hidden there is nothing to draw, sleep until somebody asks for something or the game needs checking on
+    uint32_t wait = 0;
+    if (resident.hidden) {
+      persister_submit(&persister, &library, &games);
+      bool polling = processes.count > 0 || disk_walker_busy(&walker);
+      wait = polling ? RESIDENT_HIDDEN_POLL_MS : RESIDENT_WAIT_FOREVER;
+    }
+    char *launch_name = NULL;
+    bool rescan = false;
+    Resident_Request request;
+    while (resident_take(&resident, &request, wait)) {
+      wait = 0;
+      switch (request.command) {
+      case RESIDENT_SHOW:
+        if (resident.hidden) {
+          ClearWindowState(FLAG_WINDOW_HIDDEN);
+          resident.hidden = false;
+          rescan = true;
+        }
+        SetWindowFocused();
+        render_scheduler_invalidate(&scheduler);
+        break;
+      case RESIDENT_LAUNCH:
+        free(launch_name);
+        launch_name = request.name;
+        request.name = NULL;
+        break;
+      case RESIDENT_QUIT:
+        running = false;
+        break;
+      }
+      free(request.name);
+    }
+    if (!running) break;
+    // The running game is known by its index, the catalog stays as it is until it exits
+    if (rescan && processes.count == 0 && folder_mtime(games_dir) != games_dir_mtime) {
+      games_dir_mtime = folder_mtime(games_dir);
+      // The walker and the art cache know games by index, they start over with the new catalog
+      disk_walker_drain(&walker, &library);
+      disk_walker_free(&walker);
+      art_free(&art);
+      if (games_rescan(games_dir, &games, &library)) nob_log(NOB_INFO, "Games folder changed, %zu games now", games.count);
+      library_sync(&library, &games);
+      if (!disk_walker_start(&walker, &games, &library)) {
+        nob_log(NOB_WARNING, "Could not start measuring the games on disk");
+      }
+      if (!art_init(&art, cache_dir)) {
+        free(launch_name);
+        break;
+      }
+    }
+    if (launch_name) {
+      size_t launching = find_game_by_title(&games, launch_name);
+      if (launching == SIZE_MAX) {
+        nob_log(NOB_ERROR, "There is no game titled %s", launch_name);
       } else {
-        nob_log(NOB_INFO, "Succesfully closed out of game");
+        play_game(&cmd, &processes, &library, &games, launching, &running_game, &running_since);
+        render_scheduler_invalidate(&scheduler);
       }
+      free(launch_name);
+    }
+    if (resident.hidden) continue;
+
+    if (!render_scheduler_should_draw(&scheduler)) {
+      render_scheduler_skip_frame(&scheduler);
+      profiler_count_skip(&prof);
+      continue;
     }
 
     BeginDrawing();
-    ClearBackground(RGB(12, 12, 12));
 
+    PROF_BEGIN(&prof, PROF_LAYOUT);
     Rectangle bounds = {
       .x = GENERAL_PADDING, .y = GENERAL_PADDING,
       .width = GetScreenWidth() - GENERAL_PADDING*2,
       .height = GetScreenHeight() - GENERAL_PADDING*2,
     };
-    DrawRectangleRec(bounds, RGB(16, 16, 16));
+    Rectangle search_bar = { bounds.x, bounds.y, bounds.width, SEARCH_BAR_HEIGHT };
+    if (search.depth > 0) {
+      bounds.y += SEARCH_BAR_HEIGHT + GENERAL_PADDING;
+      bounds.height -= SEARCH_BAR_HEIGHT + GENERAL_PADDING;
+    }
+    // The most recent games get a row of their own above the rest while not searching
+    Rectangle recent_bounds = { bounds.x, bounds.y, bounds.width, GAME_BUTTON_HEIGHT + GENERAL_PADDING*2 };
+    bool show_recent = search.depth == 0 && library.recent.count > 0;
+    if (show_recent) {
+      bounds.y += recent_bounds.height + GENERAL_PADDING;
+      bounds.height -= recent_bounds.height + GENERAL_PADDING;
+    }
+    ui_font_sync(&ui_font, &games);
+    Game_View view = library_view(&library);
+    if (search.depth > 0 && search_is_filter(&search)) view = filter_view(&filter, &search, &library);
+    else if (search.depth > 0) view = search_view(&search);
+    if (prof.no_layout_cache) layout.valid = recent_layout.valid = false;
+    bool relaid = layout_update(&layout, bounds, games, view, ui_font.font, GAME_BUTTON_FONT_SIZE);
+    if (relaid) focus_sync(&focus, &layout);
+    if (show_recent) {
+      relaid |= layout_update(&recent_layout, recent_bounds, games, library_recent_view(&library), ui_font.font,
+                              GAME_BUTTON_FONT_SIZE);
+    }
+    if (relaid) art_forget_positions(&art);
+    focus_reveal(&focus, &layout, &scroll, bounds);
+    float dt = MIN(GetFrameTime(), RENDER_MAX_FRAME_TIME);
+    bool scrolling = scroll_update(&scroll, GetMouseWheelMove(), dt, layout_content_height(&layout) - bounds.height);
+    PROF_END(&prof, PROF_LAYOUT);
 
-    calculate_game_buttons_positions(bounds, games, buttons);
-
-    bool hovering_any = false;
-    bool consumed = false;
-    for (GameButton *gb = buttons; gb < buttons + games.count; ++gb) {
-      Button_State btn_state = game_button(gb);
-      if (btn_state & BUTTON_STATE_HOVER) {
-        hovering_any = true;
-        if (cursor != MOUSE_CURSOR_POINTING_HAND) {
-          cursor = MOUSE_CURSOR_POINTING_HAND;
-          SetMouseCursor(cursor);
-        }
-      }
-      if (btn_state & BUTTON_STATE_CLICK && !consumed) {
-        consumed = true;
-        size_t save = nob_temp_save();
-        #ifdef _WIN32
-        const char *game_cmd = nob_temp_sprintf("%s%c%s", gb->data.folder, PATH_DELIM, gb->data.exe);
-        #else
-        const char *game_cmd = nob_temp_sprintf(".%c%s", PATH_DELIM, gb->data.exe);
-        #endif // _WIN32
-        nob_cmd_append(&cmd, game_cmd);
-        if (!nob_cmd_run(&cmd, .async = &processes, .cwd_path = gb->data.folder)) {
-          nob_log(NOB_ERROR, "Failed to fork process to open game: %s", gb->data.name);
-        } else {
-          nob_log(NOB_INFO, "Launched: %s", gb->data.name);
-        }
-        nob_temp_rewind(save);
-      }
+    PROF_BEGIN(&prof, PROF_HIT_TEST);
+    Vector2 mouse = GetMousePosition();
+    GameButton *hovered = NULL;
+    if (CheckCollisionPointRec(mouse, bounds)) {
+      hovered = layout_hit_test(&layout, (Vector2) { mouse.x, mouse.y + scroll.offset });
+    } else if (show_recent && CheckCollisionPointRec(mouse, recent_bounds)) {
+      hovered = layout_hit_test(&recent_layout, mouse);
     }
+    PROF_END(&prof, PROF_HIT_TEST);
 
-    if (!hovering_any && cursor != MOUSE_CURSOR_DEFAULT) {
-      cursor = MOUSE_CURSOR_DEFAULT;
+    MouseCursor wanted_cursor = hovered ? MOUSE_CURSOR_POINTING_HAND : MOUSE_CURSOR_DEFAULT;
+    if (cursor != wanted_cursor) {
+      cursor = wanted_cursor;
       SetMouseCursor(cursor);
     }
 
+    PROF_BEGIN(&prof, PROF_DRAW);
+    ClearBackground(RGB(12, 12, 12));
+    DrawRectangleRec(bounds, RGB(16, 16, 16));
+    if (show_recent) DrawRectangleRec(recent_bounds, RGB(20, 20, 20));
+
+    Button_State hovered_state = BUTTON_STATE_HOVER;
+    if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) hovered_state |= BUTTON_STATE_CLICK;
+
+    float view_top = bounds.y + scroll.offset;
+    float view_bottom = view_top + bounds.height;
+    size_t first_row = layout_first_row_reaching(&layout, view_top);
+    size_t end_row = first_row;
+    while (end_row < layout.rows.count && layout.rows.items[end_row].y < view_bottom) end_row += 1;
+    GameButton *first_visible = layout.items + (first_row < end_row ? layout.rows.items[first_row].start : 0);
+    GameButton *end_visible = first_row < end_row
+      ? layout.items + layout.rows.items[end_row - 1].start + layout.rows.items[end_row - 1].count
+      : first_visible;
+
+    // Only the first row of the strip fits in it
+    GameButton *recent_begin = recent_layout.items;
+    GameButton *recent_end = recent_begin;
+    if (show_recent && recent_layout.rows.count > 0) recent_end += recent_layout.rows.items[0].count;
+
+    art_sync_catalog(&art, games.count);
+    art_warm_start(&art, first_visible, end_visible);
+    // The strip goes first so a game in both places keeps where it is in the grid for eviction
+    art_request(&art, recent_begin, recent_end);
+    if (layout.rows.count > 0) {
+      size_t prefetch_first = first_row > ART_PREFETCH_ROWS ? first_row - ART_PREFETCH_ROWS : 0;
+      size_t prefetch_end = MIN(end_row + ART_PREFETCH_ROWS, layout.rows.count);
+      if (prefetch_first >= layout.rows.count) prefetch_first = layout.rows.count - 1;
+      Layout_Row last = layout.rows.items[prefetch_end - 1];
+      art_request(&art, layout.items + layout.rows.items[prefetch_first].start, layout.items + last.start + last.count);
+    }
+    PROF_END(&prof, PROF_DRAW);
+    PROF_BEGIN(&prof, PROF_DRAIN);
+    bool art_uploading = art_upload(&art);
+    art_evict(&art, view_top, view_bottom);
+    PROF_END(&prof, PROF_DRAIN);
+    PROF_BEGIN(&prof, PROF_DRAW);
+
+    if (show_recent) {
+      BeginScissorMode((int)recent_bounds.x, (int)recent_bounds.y, (int)recent_bounds.width, (int)recent_bounds.height);
+      draw_game_buttons(&tiles, &art, ui_font.font, recent_begin, recent_end, 0, hovered, hovered_state);
+      profiler_count_tiles(&prof, recent_end - recent_begin, tiles.loaded);
+      EndScissorMode();
+    }
+    BeginScissorMode((int)bounds.x, (int)bounds.y, (int)bounds.width, (int)bounds.height);
+    draw_game_buttons(&tiles, &art, ui_font.font, first_visible, end_visible, scroll.offset, hovered, hovered_state);
+    profiler_count_tiles(&prof, end_visible - first_visible, tiles.loaded);
+    if (focus.visible && focus.position < layout.count) {
+      Rectangle focused = game_button_screen_rect(&layout.items[focus.position], scroll.offset);
+      DrawRectangleRoundedLinesEx(focused, GAME_BUTTON_ROUNDNESS, GAME_BUTTON_SEGMENTS, FOCUS_LINE_THICKNESS, GAME_BUTTON_FOCUS_COLOR);
+    }
+    EndScissorMode();
+    if (search.depth > 0) search_draw(&search, search_bar, view.count, games.count);
+    tooltip_shown = hovered != NULL;
+    if (hovered) draw_game_tooltip(ui_font.font, hovered, &library.stats.items[hovered->game_index], mouse);
+    profiler_draw(&prof);
+    PROF_END(&prof, PROF_DRAW);
+
+    // A click and Enter on the focused game launch the same way
+    GameButton *activated = hovered && IsMouseButtonPressed(MOUSE_BUTTON_LEFT) ? hovered : focus_activated(&focus, &layout);
+    if (activated) play_game(&cmd, &processes, &library, &games, activated->game_index, &running_game, &running_since);
+    persister_submit(&persister, &library, &games);
+
+    // Gamepads don't wake up the event waiting, polling is the only way to see their buttons
+    bool polling = processes.count > 0 || art.in_flight > 0 || IsGamepadAvailable(0) || disk_walker_busy(&walker);
+    render_scheduler_end_frame(&scheduler, scrolling || art_uploading, polling);
+
+    PROF_BEGIN(&prof, PROF_SWAP);
     EndDrawing();
+    PROF_END(&prof, PROF_SWAP);
+    profiler_frame_end(&prof);
   }
 
+  profiler_report(&prof);
+  disk_walker_drain(&walker, &library);
+  disk_walker_free(&walker);
+  // The game can outlive the launcher, what it was played until now still counts
+  if (processes.count > 0) library_record_playtime(&library, running_game, (int64_t)time(NULL) - running_since);
+  persister_submit(&persister, &library, &games);
+  persister_stop(&persister);
+  resident_stop(&resident);
+  free(socket_path);
+  search_free(&search);
+  filter_free(&filter);
+  library_free(&library);
+  free(library_path);
+  free(library_binary_path);
+  free(library_journal_path);
+  trigram_index_free(&trigrams);
+  free(trigrams_path);
+  art_free(&art);
+  ui_font_free(&ui_font);
+  if (tiles.loaded) UnloadShader(tiles.shader);
   CloseWindow();
 
   return 0;
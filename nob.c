@@ -2,9 +2,11 @@
 #if defined(_MSC_VER) && !defined(__clang__)
 #    define nob_cc_flags(cmd) nob_cmd_append(cmd, "/W4", "/nologo", "/wd4244", "/wd4819", "/D_CRT_NONSTDC_NO_WARNINGS")
 #    define cc_debug(cmd) nob_cmd_append(cmd, "/Od", "/Ob1", "/DEBUG", "/Zi", "/DBUILD_DEBUG=1")
+#    define cc_tests(cmd) nob_cmd_append(cmd, "/O2", "/DLZUA_TESTS=1")
 #    define NOB_REBUILD_URSELF(binary_path, source_path) "cl.exe", nob_temp_sprintf("/Fe:%s", (binary_path)), source_path, "/wd4819"
 #else
 #    define cc_debug(cmd) nob_cmd_append(cmd, "-O0", "-ggdb", "-DBUILD_DEBUG=1")
+#    define cc_tests(cmd) nob_cmd_append(cmd, "-O2", "-DLZUA_TESTS=1")
 #endif // nob_cc_output
 
 #define NOB_IMPLEMENTATION
@@ -27,9 +29,12 @@ void usage(const char *program) {
   printf("    run        ---        Execute program after compiling\n");
   printf("    build      ---        Force building of program\n");
   printf("    etags      ---        Use etags to generate a TAGS file for emacs navigation\n");
+  printf("    test       ---        Build the self tests into build/lzua-test and run them\n");
+  printf("    bench      ---        Build build/lzua-test and run the benchmarks\n");
   printf("Flags\n");
   printf("    -def <dir> ---        Build program with a default search path for apps\n");
   printf("    -debug     ---        Include debug data in rebuild\n");
+  printf("    -prof      ---        Include the F3 frame profiler without a debug build\n");
 }
 
 
@@ -51,6 +56,36 @@ bool generate_tags(Cmd *cmd) {
 }
 
 
+bool build_lzua(Cmd *cmd, const char *output_path, const char *default_dir, bool include_debug, bool include_profiler,
+                bool include_tests) {
+  nob_cc(cmd);
+  nob_cc_flags(cmd);
+  nob_cc_output(cmd, output_path);
+  nob_cc_inputs(cmd, "main.c");
+  if (default_dir) {
+    cmd_append(cmd, temp_sprintf("-DDEFAULT_DIRECTORY=\"%s\"", default_dir));
+  }
+  cmd_append(cmd, CC_INCLUDE_FLAG"./lib/raylib-5.5/include/");
+  if (include_tests) cc_tests(cmd);
+  if (include_debug) cc_debug(cmd);
+  #ifdef _WIN32
+  if (include_profiler) cmd_append(cmd, "/DLZUA_PROFILER=1");
+  #else
+  if (include_profiler) cmd_append(cmd, "-DLZUA_PROFILER=1");
+  #endif
+  #ifdef _WIN32
+  nob_cc_inputs(cmd, "./lib/raylib-5.5/win32-msvc16/raylib.lib");
+  nob_cc_inputs(cmd, "opengl32.lib", "msvcrt.lib", "kernel32.lib", "user32.lib", "winmm.lib", "gdi32.lib", "shell32.lib");
+  cmd_append(cmd, "/link", "/NODEFAULTLIB:LIBCMT");
+  #else
+  nob_cc_inputs(cmd, "./lib/raylib-5.5/linux-amd64/libraylib.a");
+  cmd_append(cmd, "-lm", "-lpthread");
+  #endif
+
+  return cmd_run(cmd);
+}
+
+
 int main(int argc, char **argv) {
   NOB_GO_REBUILD_URSELF(argc, argv);
 
@@ -60,6 +95,9 @@ int main(int argc, char **argv) {
   bool run_requested = false;
   bool build_demanded = false;
   bool include_debug = false;
+  bool include_profiler = false;
+  bool test_requested = false;
+  bool bench_requested = false;
   const char *default_dir = NULL;
 
   while (argc > 0) {
@@ -76,6 +114,12 @@ int main(int argc, char **argv) {
       continue;
     }
 
+    if (streq(arg, "-prof")) {
+      include_profiler = true;
+      build_demanded = true;
+      continue;
+    }
+
     if (streq(arg, "run")) {
       run_requested = true;
       continue;
@@ -84,6 +128,14 @@ int main(int argc, char **argv) {
       build_demanded = true;
       continue;
     }
+    if (streq(arg, "test")) {
+      test_requested = true;
+      continue;
+    }
+    if (streq(arg, "bench")) {
+      bench_requested = true;
+      continue;
+    }
     if (streq(arg, "etags")) {
       if (!generate_tags(&cmd)) return 1;
       return 0;
@@ -98,26 +150,22 @@ int main(int argc, char **argv) {
 
   const char *output_path = BUILD_FOLDER"/lzua";
   if (build_demanded || needs_rebuild1(output_path, "./main.c")) {
-    nob_cc(&cmd);
-    nob_cc_flags(&cmd);
-    nob_cc_output(&cmd, output_path);
-    nob_cc_inputs(&cmd, "main.c");
-    if (default_dir) {
-      cmd_append(&cmd, temp_sprintf("-DDEFAULT_DIRECTORY=\"%s\"", default_dir));
-    }
-    cmd_append(&cmd, CC_INCLUDE_FLAG"./lib/raylib-5.5/include/");
-    if (include_debug) cc_debug(&cmd);
-    #ifdef _WIN32
-    nob_cc_inputs(&cmd, "./lib/raylib-5.5/win32-msvc16/raylib.lib");
-    nob_cc_inputs(&cmd, "opengl32.lib", "msvcrt.lib", "kernel32.lib", "user32.lib", "winmm.lib", "gdi32.lib", "shell32.lib");
-    cmd_append(&cmd, "/link", "/NODEFAULTLIB:LIBCMT");
-    #else
-    nob_cc_inputs(&cmd, "./lib/raylib-5.5/linux-amd64/libraylib.a");
-    cmd_append(&cmd, "-lm");
-    #endif
+    if (!build_lzua(&cmd, output_path, default_dir, include_debug, include_profiler, false)) return 1;
+    nob_log(INFO, "Built succesfully");
+  }
 
+  // Same source with the tests compiled in, optimized so the benchmarks mean something
+  const char *tests_path = BUILD_FOLDER"/lzua-test";
+  if ((test_requested || bench_requested) && (build_demanded || needs_rebuild1(tests_path, "./main.c"))) {
+    if (!build_lzua(&cmd, tests_path, default_dir, include_debug, include_profiler, true)) return 1;
+  }
+  if (test_requested) {
+    cmd_append(&cmd, tests_path, "--test");
+    if (!cmd_run(&cmd)) return 1;
+  }
+  if (bench_requested) {
+    cmd_append(&cmd, tests_path, "--bench");
     if (!cmd_run(&cmd)) return 1;
-    nob_log(INFO, "Built succesfully");
   }
 
   if (run_requested) {